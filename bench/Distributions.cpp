@@ -0,0 +1,234 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Distributions.h"
+// STL
+#include <cmath>
+
+namespace
+{
+
+constexpr double PI = 3.14159265358979323846;
+// 2^-53, the spacing of the doubles in [0.5, 1)
+constexpr double UNIFORM_STEP = 1.0 / 9007199254740992.0;
+
+// Gaussian clusters
+constexpr std::size_t NB_POINTS_PER_CLUSTER = 256;
+constexpr double CLUSTER_DEVIATION = 0.01;
+// Perturbation of the grid relative to the spacing
+constexpr double GRID_JITTER = 1e-3;
+// Decrease of y along a row relative to the spacing, so that the sweep line visits the rows from left to right
+constexpr double SCANLINE_SLOPE = 0.5;
+constexpr double CIRCLE_RADIUS = 0.45;
+// Relative perturbation of the radius, exactly cocircular sites are not supported
+constexpr double CIRCLE_JITTER = 1e-9;
+
+std::vector<Vector2> generateUniform(std::size_t nbPoints, RandomGenerator& generator)
+{
+    std::vector<Vector2> points;
+    points.reserve(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        double x = generator.getUniform();
+        double y = generator.getUniform();
+        points.push_back(Vector2{x, y});
+    }
+    return points;
+}
+
+std::vector<Vector2> generateClusters(std::size_t nbPoints, RandomGenerator& generator)
+{
+    std::size_t nbClusters = (nbPoints + NB_POINTS_PER_CLUSTER - 1) / NB_POINTS_PER_CLUSTER;
+    std::vector<Vector2> centers = generateUniform(nbClusters, generator);
+    std::vector<Vector2> points;
+    points.reserve(nbPoints);
+    while (points.size() < nbPoints)
+    {
+        Vector2 center = centers[generator.getIndex(nbClusters)];
+        double x = generator.getNormal(center.x, CLUSTER_DEVIATION);
+        double y = generator.getNormal(center.y, CLUSTER_DEVIATION);
+        // Rejection to stay in the unit square
+        if (x >= 0.0 && x <= 1.0 && y >= 0.0 && y <= 1.0)
+            points.push_back(Vector2{x, y});
+    }
+    return points;
+}
+
+std::vector<Vector2> generateGrid(std::size_t nbPoints, RandomGenerator& generator)
+{
+    std::size_t width = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nbPoints))));
+    double spacing = 1.0 / width;
+    double jitter = GRID_JITTER * spacing;
+    std::vector<Vector2> points;
+    points.reserve(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        double x = (i % width + 0.5) * spacing + generator.getUniform(-jitter, jitter);
+        double y = (i / width + 0.5) * spacing + generator.getUniform(-jitter, jitter);
+        points.push_back(Vector2{x, y});
+    }
+    return points;
+}
+
+std::vector<Vector2> generateScanline(std::size_t nbPoints, RandomGenerator& generator)
+{
+    std::size_t width = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nbPoints))));
+    double spacing = 1.0 / width;
+    double jitter = GRID_JITTER * spacing;
+    std::vector<Vector2> points;
+    points.reserve(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        double column = (i % width + 0.5) / width;
+        double x = column + generator.getUniform(-jitter, jitter);
+        double y = 1.0 - (i / width + 0.25 + SCANLINE_SLOPE * column) * spacing + generator.getUniform(-jitter, jitter);
+        points.push_back(Vector2{x, y});
+    }
+    return points;
+}
+
+std::vector<Vector2> generateCircle(std::size_t nbPoints, RandomGenerator& generator)
+{
+    std::vector<Vector2> points;
+    points.reserve(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        double angle = generator.getUniform(0.0, 2.0 * PI);
+        double radius = CIRCLE_RADIUS * (1.0 + generator.getUniform(-CIRCLE_JITTER, CIRCLE_JITTER));
+        points.push_back(Vector2{0.5 + radius * std::cos(angle), 0.5 + radius * std::sin(angle)});
+    }
+    return points;
+}
+
+// Only sqrt(nbPoints) distinct values for one of the coordinates
+std::vector<Vector2> generateDuplicates(std::size_t nbPoints, RandomGenerator& generator, bool duplicateX)
+{
+    std::size_t nbValues = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nbPoints))));
+    std::vector<Vector2> values = generateUniform(nbValues, generator);
+    std::vector<Vector2> points;
+    points.reserve(nbPoints);
+    for (std::size_t i = 0; i < nbPoints; ++i)
+    {
+        double value = values[generator.getIndex(nbValues)].x;
+        double other = generator.getUniform();
+        points.push_back(duplicateX ? Vector2{value, other} : Vector2{other, value});
+    }
+    return points;
+}
+
+}
+
+RandomGenerator::RandomGenerator(std::uint64_t seed) : mGenerator(seed)
+{
+
+}
+
+std::uint64_t RandomGenerator::getBits()
+{
+    return mGenerator();
+}
+
+double RandomGenerator::getUniform()
+{
+    // The 53 high bits fill the mantissa
+    return static_cast<double>(getBits() >> 11) * UNIFORM_STEP;
+}
+
+double RandomGenerator::getUniform(double min, double max)
+{
+    return min + (max - min) * getUniform();
+}
+
+std::size_t RandomGenerator::getIndex(std::size_t size)
+{
+    return static_cast<std::size_t>(getBits() % size);
+}
+
+double RandomGenerator::getNormal(double mean, double deviation)
+{
+    // 1 - u is in (0, 1] so that its logarithm is finite
+    double radius = std::sqrt(-2.0 * std::log(1.0 - getUniform()));
+    double angle = 2.0 * PI * getUniform();
+    return mean + deviation * radius * std::cos(angle);
+}
+
+const std::vector<Distribution>& getDistributions()
+{
+    static const std::vector<Distribution> distributions = {Distribution::UNIFORM, Distribution::CLUSTERS,
+        Distribution::GRID, Distribution::SCANLINE, Distribution::CIRCLE, Distribution::DUPLICATE_X, Distribution::DUPLICATE_Y};
+    return distributions;
+}
+
+std::string getName(Distribution distribution)
+{
+    switch (distribution)
+    {
+        case Distribution::UNIFORM:
+            return "uniform";
+        case Distribution::CLUSTERS:
+            return "clusters";
+        case Distribution::GRID:
+            return "grid";
+        case Distribution::SCANLINE:
+            return "scanline";
+        case Distribution::CIRCLE:
+            return "circle";
+        case Distribution::DUPLICATE_X:
+            return "duplicate-x";
+        case Distribution::DUPLICATE_Y:
+            return "duplicate-y";
+    }
+    return "";
+}
+
+bool parseDistribution(const std::string& name, Distribution& distribution)
+{
+    for (Distribution candidate : getDistributions())
+    {
+        if (getName(candidate) == name)
+        {
+            distribution = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Vector2> generatePoints(Distribution distribution, std::size_t nbPoints, std::uint64_t seed)
+{
+    if (nbPoints == 0)
+        return {};
+    RandomGenerator generator(seed);
+    switch (distribution)
+    {
+        case Distribution::UNIFORM:
+            return generateUniform(nbPoints, generator);
+        case Distribution::CLUSTERS:
+            return generateClusters(nbPoints, generator);
+        case Distribution::GRID:
+            return generateGrid(nbPoints, generator);
+        case Distribution::SCANLINE:
+            return generateScanline(nbPoints, generator);
+        case Distribution::CIRCLE:
+            return generateCircle(nbPoints, generator);
+        case Distribution::DUPLICATE_X:
+            return generateDuplicates(nbPoints, generator, true);
+        case Distribution::DUPLICATE_Y:
+            return generateDuplicates(nbPoints, generator, false);
+    }
+    return {};
+}
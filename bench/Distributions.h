@@ -0,0 +1,54 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+// My includes
+#include "Vector2.h"
+
+// Random numbers computed from the raw output of std::mt19937_64, which is specified by the standard unlike the
+// algorithms of the std distributions, so that a seed gives the same numbers with every standard library
+class RandomGenerator
+{
+public:
+    explicit RandomGenerator(std::uint64_t seed);
+
+    std::uint64_t getBits();
+    double getUniform(); // In [0, 1)
+    double getUniform(double min, double max); // In [min, max)
+    std::size_t getIndex(std::size_t size); // In [0, size), the bias of the modulo is negligible for the sizes used
+    double getNormal(double mean, double deviation); // Box-Muller transform, one value per pair of uniform numbers
+
+private:
+    std::mt19937_64 mGenerator;
+};
+
+// Deterministic point sets in the unit square
+// SCANLINE: rows of sites in which y decreases with x, the sweep line visits them in the order of generation
+enum class Distribution{UNIFORM, CLUSTERS, GRID, SCANLINE, CIRCLE, DUPLICATE_X, DUPLICATE_Y};
+
+const std::vector<Distribution>& getDistributions();
+std::string getName(Distribution distribution);
+bool parseDistribution(const std::string& name, Distribution& distribution);
+
+std::vector<Vector2> generatePoints(Distribution distribution, std::size_t nbPoints, std::uint64_t seed);
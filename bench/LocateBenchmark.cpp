@@ -0,0 +1,213 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LocateBenchmark.h"
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+// My includes
+#include "Arc.h"
+#include "Beachline.h"
+#include "BTreeBeachline.h"
+#include "Distributions.h"
+
+namespace
+{
+
+constexpr double SWEEP_LINE_Y = 0.0;
+
+// The sites are at most a quarter of their spacing above the sweep line so that each of them has an arc
+std::vector<VoronoiDiagram::Site> generateSites(std::size_t nbArcs, RandomGenerator& generator)
+{
+    double spacing = 1.0 / nbArcs;
+    std::vector<VoronoiDiagram::Site> sites;
+    for (std::size_t i = 0; i < nbArcs; ++i)
+    {
+        double x = (i + 0.25 + 0.5 * generator.getUniform()) * spacing;
+        double y = SWEEP_LINE_Y + 0.25 * spacing * (1.0 - generator.getUniform());
+        sites.push_back(VoronoiDiagram::Site{i, Vector2(x, y), nullptr});
+    }
+    return sites;
+}
+
+// Previous version of the breakpoint computation, with divisions and a square root
+double computeBreakpoint(const Vector2& point1, const Vector2& point2, double l)
+{
+    double x1 = point1.x, y1 = point1.y, x2 = point2.x, y2 = point2.y;
+    if (y1 == y2)
+        return 0.5 * (x1 + x2);
+    if (y1 == l)
+        return x1;
+    if (y2 == l)
+        return x2;
+    double d1 = 1.0 / (2.0 * (y1 - l));
+    double d2 = 1.0 / (2.0 * (y2 - l));
+    double a = d1 - d2;
+    double b = 2.0 * (x2 * d2 - x1 * d1);
+    double c = (y1 * y1 + x1 * x1 - l * l) * d1 - (y2 * y2 + x2 * x2 - l * l) * d2;
+    double delta = b * b - 4.0 * a * c;
+    return (-b + std::sqrt(delta)) / (2.0 * a);
+}
+
+// Fill the beachline from left to right
+template<typename T>
+void fillBeachline(T& beachline, std::vector<VoronoiDiagram::Site>& sites)
+{
+    Arc* last = beachline.createArc(&sites[0]);
+    beachline.setRoot(last);
+    for (std::size_t i = 1; i < sites.size(); ++i)
+    {
+        Arc* arc = beachline.createArc(&sites[i]);
+        beachline.insertAfter(last, arc);
+        last = arc;
+    }
+}
+
+template<typename T>
+std::chrono::nanoseconds locateArcs(const T& beachline, const std::vector<Vector2>& points, std::vector<const Arc*>& arcs)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < points.size(); ++i)
+        arcs[i] = beachline.locateArcAbove(points[i], SWEEP_LINE_Y);
+    return std::chrono::steady_clock::now() - start;
+}
+
+// Arcs are compared through their sites as each beachline has its own arcs
+std::size_t countMismatches(const std::vector<const Arc*>& arcs, const std::vector<const Arc*>& referenceArcs)
+{
+    std::size_t nbMismatches = 0;
+    for (std::size_t i = 0; i < arcs.size(); ++i)
+        nbMismatches += arcs[i]->site != referenceArcs[i]->site;
+    return nbMismatches;
+}
+
+// Operations drawn before running them so that both beachlines execute the same sequence
+struct Operation
+{
+    std::size_t arc; // Index in the arcs currently in the beachline
+    bool isBefore; // Only for insertions
+};
+
+template<typename T>
+std::chrono::nanoseconds updateBeachline(std::vector<VoronoiDiagram::Site>& sites, const std::vector<Operation>& insertions,
+    const std::vector<Operation>& removals)
+{
+    T beachline;
+    std::vector<Arc*> arcs;
+    arcs.reserve(sites.size());
+    auto start = std::chrono::steady_clock::now();
+    arcs.push_back(beachline.createArc(&sites[0]));
+    beachline.setRoot(arcs.back());
+    for (std::size_t i = 1; i < sites.size(); ++i)
+    {
+        Arc* arc = beachline.createArc(&sites[i]);
+        const Operation& insertion = insertions[i];
+        if (insertion.isBefore)
+            beachline.insertBefore(arcs[insertion.arc], arc);
+        else
+            beachline.insertAfter(arcs[insertion.arc], arc);
+        arcs.push_back(arc);
+    }
+    for (Arc*& arc : arcs)
+    {
+        Arc* newArc = beachline.createArc(arc->site);
+        beachline.replace(arc, newArc);
+        beachline.deleteArc(arc);
+        arc = newArc;
+    }
+    for (const Operation& removal : removals)
+    {
+        Arc* arc = arcs[removal.arc];
+        beachline.remove(arc);
+        beachline.deleteArc(arc);
+        arcs[removal.arc] = arcs.back();
+        arcs.pop_back();
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
+const Arc* locateReference(const Beachline& beachline, const Arc* root, const Vector2& point, double l)
+{
+    const Arc* node = root;
+    while (true)
+    {
+        double breakpointLeft = -std::numeric_limits<double>::infinity();
+        double breakpointRight = std::numeric_limits<double>::infinity();
+        if (!beachline.isNil(node->prev))
+            breakpointLeft = computeBreakpoint(node->prev->site->point, node->site->point, l);
+        if (!beachline.isNil(node->next))
+            breakpointRight = computeBreakpoint(node->site->point, node->next->site->point, l);
+        if (point.x < breakpointLeft)
+            node = node->left;
+        else if (point.x > breakpointRight)
+            node = node->right;
+        else
+            return node;
+    }
+}
+
+}
+
+LocateTimings benchmarkLocations(std::size_t nbArcs, std::size_t nbLocations, std::uint64_t seed)
+{
+    RandomGenerator generator(seed);
+    std::vector<VoronoiDiagram::Site> sites = generateSites(std::max<std::size_t>(nbArcs, 1), generator);
+    std::vector<Vector2> points;
+    for (std::size_t i = 0; i < nbLocations; ++i)
+        points.push_back(Vector2(generator.getUniform(), SWEEP_LINE_Y));
+    Beachline redBlackTree;
+    fillBeachline(redBlackTree, sites);
+    BTreeBeachline bTree;
+    fillBeachline(bTree, sites);
+    // Locate the points with the three versions
+    LocateTimings timings;
+    timings.nbLocations = nbLocations;
+    std::vector<const Arc*> redBlackTreeArcs(nbLocations);
+    timings.redBlackTree = locateArcs(redBlackTree, points, redBlackTreeArcs);
+    std::vector<const Arc*> bTreeArcs(nbLocations);
+    timings.bTree = locateArcs(bTree, points, bTreeArcs);
+    const Arc* root = redBlackTree.getLeftmostArc();
+    while (!redBlackTree.isNil(root->parent))
+        root = root->parent;
+    std::vector<const Arc*> referenceArcs(nbLocations);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < nbLocations; ++i)
+        referenceArcs[i] = locateReference(redBlackTree, root, points[i], SWEEP_LINE_Y);
+    timings.reference = std::chrono::steady_clock::now() - start;
+    timings.nbRedBlackTreeMismatches = countMismatches(redBlackTreeArcs, referenceArcs);
+    timings.nbBTreeMismatches = countMismatches(bTreeArcs, referenceArcs);
+    return timings;
+}
+
+UpdateTimings benchmarkUpdates(std::size_t nbArcs, std::uint64_t seed)
+{
+    RandomGenerator generator(seed);
+    std::vector<VoronoiDiagram::Site> sites = generateSites(std::max<std::size_t>(nbArcs, 1), generator);
+    std::vector<Operation> insertions(sites.size());
+    for (std::size_t i = 1; i < sites.size(); ++i)
+        insertions[i] = Operation{generator.getIndex(i), (generator.getBits() & 1) != 0};
+    std::vector<Operation> removals(sites.size());
+    for (std::size_t i = 0; i < sites.size(); ++i)
+        removals[i] = Operation{generator.getIndex(sites.size() - i), false};
+    UpdateTimings timings;
+    timings.nbOperations = 3 * sites.size();
+    timings.redBlackTree = updateBeachline<Beachline>(sites, insertions, removals);
+    timings.bTree = updateBeachline<BTreeBeachline>(sites, insertions, removals);
+    return timings;
+}
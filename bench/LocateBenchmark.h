@@ -0,0 +1,49 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <chrono>
+#include <cstdint>
+
+// Cost of Beachline::locateArcAbove and BTreeBeachline::locateArcAbove compared to a descent computing the breakpoints
+// explicitly
+// The beachlines contain nbArcs arcs of sites just above the sweep line, the points are uniformly distributed
+struct LocateTimings
+{
+    std::size_t nbLocations;
+    // Locations for which the beachlines and the reference return different arcs
+    std::size_t nbRedBlackTreeMismatches;
+    std::size_t nbBTreeMismatches;
+    std::chrono::nanoseconds redBlackTree;
+    std::chrono::nanoseconds bTree;
+    std::chrono::nanoseconds reference;
+};
+
+LocateTimings benchmarkLocations(std::size_t nbArcs, std::size_t nbLocations, std::uint64_t seed);
+
+// Updates of both beachlines with the same random sequence of operations
+// nbArcs arcs are inserted before or after random arcs, then each arc is replaced and finally all are removed
+struct UpdateTimings
+{
+    std::size_t nbOperations;
+    std::chrono::nanoseconds redBlackTree;
+    std::chrono::nanoseconds bTree;
+};
+
+UpdateTimings benchmarkUpdates(std::size_t nbArcs, std::uint64_t seed);
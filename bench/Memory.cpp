@@ -0,0 +1,72 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Memory.h"
+// STL
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+std::size_t getPeakMemoryUsage()
+{
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            std::istringstream stream(line.substr(6));
+            std::size_t size = 0;
+            stream >> size;
+            return size * 1024;
+        }
+    }
+    return 0;
+}
+
+bool resetPeakMemoryUsage()
+{
+#ifdef __GLIBC__
+    // Give the memory freed by the previous runs back to the system
+    malloc_trim(0);
+#endif
+    // Writing 5 in clear_refs resets VmHWM since Linux 4.0
+    std::ofstream file("/proc/self/clear_refs");
+    file << "5";
+    file.close();
+    return static_cast<bool>(file);
+}
+
+#else
+
+std::size_t getPeakMemoryUsage()
+{
+    return 0;
+}
+
+bool resetPeakMemoryUsage()
+{
+    return false;
+}
+
+#endif
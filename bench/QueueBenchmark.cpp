@@ -0,0 +1,179 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QueueBenchmark.h"
+// STL
+#include <memory>
+#include <vector>
+// My includes
+#include "Event.h"
+#include "EventQueue.h"
+#include "PriorityQueue.h"
+#include "Distributions.h"
+
+namespace
+{
+
+enum class OperationType{PUSH, POP, REMOVE};
+
+struct Operation
+{
+    OperationType type;
+    double y; // Priority of a pushed event
+    std::size_t position; // Position in the live events of a removed event
+};
+
+struct Element
+{
+    double y;
+    std::size_t id;
+    std::size_t index; // Set by PriorityQueue
+
+    bool operator<(const Element& other) const
+    {
+        return y < other.y;
+    }
+};
+
+std::vector<Operation> generateOperations(std::size_t nbEvents, std::uint64_t seed)
+{
+    RandomGenerator generator(seed);
+    std::vector<Operation> operations;
+    for (std::size_t i = 0; i < nbEvents; ++i)
+        operations.push_back(Operation{OperationType::PUSH, generator.getUniform(), 0});
+    // As many pops as pushes and removals, pushes limited to nbEvents more events
+    std::size_t size = nbEvents;
+    std::size_t nbPushesLeft = nbEvents;
+    while (size > 0)
+    {
+        std::size_t type = generator.getIndex(4);
+        if (type == 2 && nbPushesLeft > 0)
+        {
+            operations.push_back(Operation{OperationType::PUSH, generator.getUniform(), 0});
+            ++size;
+            --nbPushesLeft;
+        }
+        else if (type == 3)
+        {
+            operations.push_back(Operation{OperationType::REMOVE, 0.0, generator.getIndex(size)});
+            --size;
+        }
+        else
+        {
+            operations.push_back(Operation{OperationType::POP, 0.0, 0});
+            --size;
+        }
+    }
+    return operations;
+}
+
+// Live events: identifiers and their positions, a removed event is swapped with the last one
+class LiveEvents
+{
+public:
+    void add(std::size_t id)
+    {
+        if (id >= mPositions.size())
+            mPositions.resize(id + 1);
+        mPositions[id] = mIds.size();
+        mIds.push_back(id);
+    }
+
+    std::size_t get(std::size_t position) const
+    {
+        return mIds[position];
+    }
+
+    void remove(std::size_t id)
+    {
+        std::size_t position = mPositions[id];
+        mIds[position] = mIds.back();
+        mPositions[mIds[position]] = position;
+        mIds.pop_back();
+    }
+
+private:
+    std::vector<std::size_t> mIds;
+    std::vector<std::size_t> mPositions;
+};
+
+std::chrono::nanoseconds runEventQueue(const std::vector<Operation>& operations)
+{
+    auto start = std::chrono::steady_clock::now();
+    EventQueue queue;
+    LiveEvents events;
+    std::vector<EventQueue::Handle> handles;
+    for (const Operation& operation : operations)
+    {
+        if (operation.type == OperationType::PUSH)
+        {
+            // The identifier is stored in the x coordinate
+            std::size_t id = handles.size();
+            handles.push_back(queue.push(operation.y, Event(Vector2(static_cast<double>(id), operation.y), nullptr)));
+            events.add(id);
+        }
+        else if (operation.type == OperationType::POP)
+            events.remove(static_cast<std::size_t>(queue.pop().point.x));
+        else
+        {
+            std::size_t id = events.get(operation.position);
+            queue.remove(handles[id]);
+            events.remove(id);
+        }
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
+std::chrono::nanoseconds runPriorityQueue(const std::vector<Operation>& operations)
+{
+    auto start = std::chrono::steady_clock::now();
+    PriorityQueue<Element> queue;
+    LiveEvents events;
+    std::vector<Element*> elements;
+    for (const Operation& operation : operations)
+    {
+        if (operation.type == OperationType::PUSH)
+        {
+            std::size_t id = elements.size();
+            auto element = std::make_unique<Element>(Element{operation.y, id, 0});
+            elements.push_back(element.get());
+            queue.push(std::move(element));
+            events.add(id);
+        }
+        else if (operation.type == OperationType::POP)
+            events.remove(queue.pop()->id);
+        else
+        {
+            std::size_t id = events.get(operation.position);
+            queue.remove(elements[id]->index);
+            events.remove(id);
+        }
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
+}
+
+QueueTimings benchmarkQueues(std::size_t nbEvents, std::uint64_t seed)
+{
+    std::vector<Operation> operations = generateOperations(nbEvents, seed);
+    QueueTimings timings;
+    timings.nbOperations = operations.size();
+    timings.eventQueue = runEventQueue(operations);
+    timings.priorityQueue = runPriorityQueue(operations);
+    return timings;
+}
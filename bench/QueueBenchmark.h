@@ -15,29 +15,19 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "Event.h"
+#pragma once
 
-Event::Event(VoronoiDiagram::Site* site) : type(Type::SITE), y(site->point.y), index(-1), site(site)
-{
-
-}
-
-Event::Event(double y, Vector2 point, Arc* arc) : type(Type::CIRCLE), y(y), index(-1), point(point), arc(arc)
-{
-
-
-}
-bool operator<(const Event& lhs, const Event& rhs)
-{
-    return lhs.y < rhs.y;
-}
+// STL
+#include <chrono>
+#include <cstdint>
 
-std::ostream& operator<<(std::ostream& os, const Event& event)
+// Comparison of EventQueue and PriorityQueue on the same random sequence of operations
+// nbEvents events are pushed, then pops, pushes and removals are interleaved until the queue is empty
+struct QueueTimings
 {
-    if(event.type == Event::Type::SITE)
-        os << "S(" << event.site->index << ", " << event.y << ")";
-    else
-        os << "C(" << event.arc << ", " << event.y << ", " << event.point << ")";
-    return os;
-}
+    std::size_t nbOperations;
+    std::chrono::nanoseconds eventQueue;
+    std::chrono::nanoseconds priorityQueue;
+};
 
+QueueTimings benchmarkQueues(std::size_t nbEvents, std::uint64_t seed);
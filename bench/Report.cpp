@@ -0,0 +1,138 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Report.h"
+// STL
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+
+// Numbers and booleans are not quoted in JSON
+bool isLiteral(const std::string& value)
+{
+    if (value == "true" || value == "false")
+        return true;
+    if (value.empty())
+        return false;
+    char* end = nullptr;
+    double number = std::strtod(value.c_str(), &end);
+    return *end == '\0' && std::isfinite(number);
+}
+
+std::string quote(const std::string& value)
+{
+    std::string quoted = "\"";
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += c;
+    }
+    return quoted + '"';
+}
+
+}
+
+Report::Report(std::ostream& os, Format format) : mOutputStream(os), mFormat(format)
+{
+
+}
+
+void Report::beginTable(const std::string& name, std::vector<std::string> columns)
+{
+    if (mFormat == Format::CSV)
+    {
+        if (!mTables.empty())
+            mOutputStream << '\n';
+        for (std::size_t i = 0; i < columns.size(); ++i)
+            mOutputStream << (i > 0 ? "," : "") << columns[i];
+        mOutputStream << std::endl;
+    }
+    mTables.push_back(Table{name, std::move(columns), {}});
+}
+
+void Report::addRow(const std::vector<std::string>& values)
+{
+    if (mFormat == Format::CSV)
+    {
+        for (std::size_t i = 0; i < values.size(); ++i)
+            mOutputStream << (i > 0 ? "," : "") << values[i];
+        mOutputStream << std::endl;
+    }
+    else
+        mTables.back().rows.push_back(values);
+}
+
+void Report::finish()
+{
+    if (mFormat == Format::JSON)
+        writeJson();
+}
+
+void Report::writeJson() const
+{
+    mOutputStream << "{\n";
+    for (std::size_t i = 0; i < mTables.size(); ++i)
+    {
+        const Table& table = mTables[i];
+        mOutputStream << "  " << quote(table.name) << ": [";
+        for (std::size_t j = 0; j < table.rows.size(); ++j)
+        {
+            mOutputStream << (j > 0 ? ",\n    {" : "\n    {");
+            for (std::size_t k = 0; k < table.columns.size(); ++k)
+            {
+                const std::string& value = table.rows[j][k];
+                mOutputStream << (k > 0 ? ", " : "") << quote(table.columns[k]) << ": " <<
+                    (isLiteral(value) ? value : quote(value));
+            }
+            mOutputStream << '}';
+        }
+        mOutputStream << (table.rows.empty() ? "]" : "\n  ]") << (i + 1 < mTables.size() ? ",\n" : "\n");
+    }
+    mOutputStream << "}" << std::endl;
+}
+
+std::string toCell(const std::string& value)
+{
+    return value;
+}
+
+std::string toCell(const char* value)
+{
+    return value;
+}
+
+std::string toCell(double value)
+{
+    std::ostringstream stream;
+    stream.precision(6);
+    stream << value;
+    return stream.str();
+}
+
+std::string toCell(std::size_t value)
+{
+    return std::to_string(value);
+}
+
+std::string toCell(bool value)
+{
+    return value ? "true" : "false";
+}
@@ -0,0 +1,60 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Tables of results written as CSV or JSON
+// In CSV, the tables are separated by an empty line and their rows are written immediately.
+// In JSON, an object mapping the names of the tables to arrays of rows is written by finish.
+// The numbers and booleans are not quoted in JSON.
+class Report
+{
+public:
+    enum class Format{CSV, JSON};
+
+    Report(std::ostream& os, Format format);
+
+    void beginTable(const std::string& name, std::vector<std::string> columns);
+    void addRow(const std::vector<std::string>& values);
+    void finish();
+
+private:
+    struct Table
+    {
+        std::string name;
+        std::vector<std::string> columns;
+        std::vector<std::vector<std::string>> rows;
+    };
+
+    std::ostream& mOutputStream;
+    Format mFormat;
+    std::vector<Table> mTables;
+
+    void writeJson() const;
+};
+
+// Conversion of values to cells
+std::string toCell(const std::string& value);
+std::string toCell(const char* value);
+std::string toCell(double value);
+std::string toCell(std::size_t value);
+std::string toCell(bool value);
@@ -0,0 +1,959 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// STL
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+// My includes
+#include "FortuneAlgorithm.h"
+#include "ParallelFortuneAlgorithm.h"
+#include "BatchFortuneAlgorithm.h"
+#include "DiagramCodec.h"
+#include "RingBuffer.h"
+#include "Distributions.h"
+#include "LocateBenchmark.h"
+#include "Memory.h"
+#include "QueueBenchmark.h"
+#include "Report.h"
+
+constexpr Box BOX{0.0, 0.0, 1.0, 1.0};
+constexpr Box BOUNDING_BOX{-0.05, -0.05, 1.05, 1.05}; // Slightly bigger than the intersection box
+// Integer suite, the points are snapped to grids of these sizes, the coarse one creates many cocircular sites
+constexpr double COARSE_INTEGER_GRID_SIZE = 4096.0;
+constexpr double FINE_INTEGER_GRID_SIZE = 1073741824.0;
+// Batch suite
+constexpr std::size_t MIN_BATCH_DIAGRAM_SIZE = 100;
+constexpr std::size_t MAX_BATCH_DIAGRAM_SIZE = 10000;
+// Locate suite
+constexpr std::size_t NB_LOCATIONS = 1000000;
+// Compress suite, 0 means exact vertices
+const std::vector<int> QUANTIZATION_NB_BITS = {0, 16};
+// Mapped suite, the file is written in the working directory and removed afterwards
+constexpr const char* MAPPED_DIAGRAM_PATH = "FortuneBenchmark.diagram";
+// Number of cells in flight between the sweep and the consumer thread
+constexpr std::size_t RING_CAPACITY = 1024;
+
+struct Options
+{
+    std::vector<std::string> suites = {"phases", "queue"};
+    std::vector<std::size_t> sizes = {1000, 10000, 100000, 1000000, 10000000};
+    std::vector<Distribution> distributions = getDistributions();
+    FortuneAlgorithm::SiteEventMode mode = FortuneAlgorithm::SiteEventMode::SORTED;
+    FortuneAlgorithm::LocationMode locationMode = FortuneAlgorithm::LocationMode::ROOT;
+    std::size_t nbRepetitions = 1;
+    std::uint64_t seed = 1;
+    std::vector<std::size_t> nbThreads;
+    std::size_t batchSize = 1000;
+    Report::Format format = Report::Format::CSV;
+    std::string output;
+};
+
+const char* USAGE =
+    "Usage: FortuneBenchmark [options]\n"
+    "  --suites LIST          phases, policies, precision, integer, finalize, stream, mapped, compress, parallel, batch, queue, locate, update (default: phases,queue)\n"
+    "  --sizes LIST           numbers of sites (default: 1000,10000,100000,1000000,10000000)\n"
+    "  --max-size N           ignore the sizes greater than N\n"
+    "  --distributions LIST   uniform, clusters, grid, scanline, circle, duplicate-x, duplicate-y (default: all)\n"
+    "  --mode MODE            heap or sorted (default: sorted)\n"
+    "  --location MODE        root or hint, start of the search of the arc above each site (default: root)\n"
+    "  --repetitions N        runs per configuration (default: 1)\n"
+    "  --seed N               seed of the first repetition (default: 1)\n"
+    "  --threads LIST         numbers of threads of the parallel and batch suites (default: 1,2,4,... up to the number of cores)\n"
+    "  --batch-size N         number of diagrams of the batch suite (default: 1000)\n"
+    "  --format FORMAT        csv or json (default: csv)\n"
+    "  --output FILE          output file (default: standard output)\n";
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> values;
+    std::istringstream stream(list);
+    std::string value;
+    while (std::getline(stream, value, ','))
+    {
+        if (!value.empty())
+            values.push_back(value);
+    }
+    return values;
+}
+
+std::size_t parseSize(const std::string& value)
+{
+    // Accept scientific notation like 1e6
+    std::size_t end = 0;
+    double size = std::stod(value, &end);
+    if (end != value.size() || size < 0.0)
+        throw std::invalid_argument("Invalid number: " + value);
+    return static_cast<std::size_t>(size);
+}
+
+std::vector<std::size_t> parseSizes(const std::string& list)
+{
+    std::vector<std::size_t> sizes;
+    for (const std::string& value : split(list))
+        sizes.push_back(parseSize(value));
+    return sizes;
+}
+
+Options parseOptions(int argc, char* argv[])
+{
+    Options options;
+    std::size_t maxSize = std::numeric_limits<std::size_t>::max();
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string name = argv[i];
+        if (name == "--help")
+        {
+            std::cout << USAGE;
+            std::exit(0);
+        }
+        if (i + 1 >= argc)
+            throw std::invalid_argument("Missing value for " + name);
+        std::string value = argv[++i];
+        if (name == "--suites")
+            options.suites = split(value);
+        else if (name == "--sizes")
+            options.sizes = parseSizes(value);
+        else if (name == "--max-size")
+            maxSize = parseSize(value);
+        else if (name == "--distributions")
+        {
+            options.distributions.clear();
+            for (const std::string& distributionName : split(value))
+            {
+                Distribution distribution;
+                if (!parseDistribution(distributionName, distribution))
+                    throw std::invalid_argument("Unknown distribution: " + distributionName);
+                options.distributions.push_back(distribution);
+            }
+        }
+        else if (name == "--mode")
+        {
+            if (value != "heap" && value != "sorted")
+                throw std::invalid_argument("Unknown mode: " + value);
+            options.mode = value == "heap" ? FortuneAlgorithm::SiteEventMode::HEAP : FortuneAlgorithm::SiteEventMode::SORTED;
+        }
+        else if (name == "--location")
+        {
+            if (value != "root" && value != "hint")
+                throw std::invalid_argument("Unknown location mode: " + value);
+            options.locationMode = value == "root" ? FortuneAlgorithm::LocationMode::ROOT :
+                FortuneAlgorithm::LocationMode::HINT;
+        }
+        else if (name == "--repetitions")
+            options.nbRepetitions = parseSize(value);
+        else if (name == "--seed")
+            options.seed = parseSize(value);
+        else if (name == "--threads")
+            options.nbThreads = parseSizes(value);
+        else if (name == "--batch-size")
+            options.batchSize = parseSize(value);
+        else if (name == "--format")
+        {
+            if (value != "csv" && value != "json")
+                throw std::invalid_argument("Unknown format: " + value);
+            options.format = value == "csv" ? Report::Format::CSV : Report::Format::JSON;
+        }
+        else if (name == "--output")
+            options.output = value;
+        else
+            throw std::invalid_argument("Unknown option: " + name);
+    }
+    options.sizes.erase(std::remove_if(options.sizes.begin(), options.sizes.end(),
+        [maxSize](std::size_t size){ return size > maxSize; }), options.sizes.end());
+    if (options.nbThreads.empty())
+    {
+        std::size_t nbCores = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        for (std::size_t nbThreads = 1; nbThreads < nbCores; nbThreads *= 2)
+            options.nbThreads.push_back(nbThreads);
+        options.nbThreads.push_back(nbCores);
+    }
+    return options;
+}
+
+template<typename Duration>
+std::size_t toNanoseconds(Duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+// Construction, bounding and intersection with the sequential algorithm
+void runPhases(const Options& options, Report& report)
+{
+    std::vector<std::string> columns = {"distribution", "n", "seed", "mode", "location", "initialization_ns",
+        "sweep_ns", "construct_ns", "bound_ns", "intersect_ns", "total_ns", "ns_per_site", "events", "vertices",
+        "half_edges", "diagram_memory", "peak_memory", "valid"};
+    if (Statistics::ENABLED)
+        columns.insert(columns.end(), {"site_events", "circle_events", "triplets", "created_circle_events",
+            "deleted_circle_events", "false_alarm_rate", "rejection_rate", "max_event_queue_size", "max_beachline_size",
+            "average_location_depth", "hinted_locations", "saved_location_steps", "rotations"});
+    report.beginTable("phases", columns);
+    std::string mode = options.mode == FortuneAlgorithm::SiteEventMode::HEAP ? "heap" : "sorted";
+    std::string location = options.locationMode == FortuneAlgorithm::LocationMode::ROOT ? "root" : "hint";
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                resetPeakMemoryUsage();
+                auto start = std::chrono::steady_clock::now();
+                FortuneAlgorithm algorithm(points);
+                algorithm.construct(options.mode, options.locationMode);
+                auto constructEnd = std::chrono::steady_clock::now();
+                bool valid = algorithm.bound(BOUNDING_BOX);
+                auto boundEnd = std::chrono::steady_clock::now();
+                VoronoiDiagram diagram = algorithm.getDiagram();
+                valid = diagram.intersect(BOX) && valid;
+                auto end = std::chrono::steady_clock::now();
+                std::size_t peakMemory = getPeakMemoryUsage();
+                std::size_t total = toNanoseconds(end - start);
+                std::vector<std::string> row = {toCell(getName(distribution)), toCell(nbPoints),
+                    toCell(static_cast<std::size_t>(seed)), toCell(mode), toCell(location),
+                    toCell(toNanoseconds(algorithm.getTimings().initialization)),
+                    toCell(toNanoseconds(algorithm.getTimings().sweep)), toCell(toNanoseconds(constructEnd - start)),
+                    toCell(toNanoseconds(boundEnd - constructEnd)), toCell(toNanoseconds(end - boundEnd)), toCell(total),
+                    toCell(static_cast<double>(total) / std::max<std::size_t>(nbPoints, 1)),
+                    toCell(algorithm.getNbProcessedEvents()), toCell(diagram.getVertices().getSize()),
+                    toCell(diagram.getHalfEdges().getSize()), toCell(diagram.getMemoryUsage()), toCell(peakMemory),
+                    toCell(valid)};
+                if (Statistics::ENABLED)
+                {
+                    const Statistics& statistics = algorithm.getStatistics();
+                    row.insert(row.end(), {toCell(statistics.nbSiteEvents), toCell(statistics.nbCircleEvents),
+                        toCell(statistics.nbTriplets), toCell(statistics.nbCreatedCircleEvents),
+                        toCell(statistics.nbDeletedCircleEvents), toCell(statistics.getFalseAlarmRate()),
+                        toCell(statistics.getRejectionRate()), toCell(statistics.maxEventQueueSize),
+                        toCell(statistics.maxBeachlineSize), toCell(statistics.getAverageLocationDepth()),
+                        toCell(statistics.nbHintedLocations), toCell(statistics.getAverageSavedLocationSteps()),
+                        toCell(statistics.nbRotations)});
+                }
+                report.addRow(row);
+            }
+        }
+    }
+}
+
+// Construction and finalization of the same points with a beachline and an event queue
+template<typename B, typename Q>
+void addPolicyRow(const Options& options, Report& report, Distribution distribution, std::uint64_t seed,
+    const std::vector<Vector2>& points, const char* beachline, const char* queue)
+{
+    auto start = std::chrono::steady_clock::now();
+    BasicFortuneAlgorithm<B, Q> algorithm(points);
+    algorithm.construct(options.mode, options.locationMode);
+    auto constructEnd = std::chrono::steady_clock::now();
+    bool valid = algorithm.finalize(BOX);
+    auto end = std::chrono::steady_clock::now();
+    VoronoiDiagram diagram = algorithm.getDiagram();
+    std::size_t total = toNanoseconds(end - start);
+    report.addRow({toCell(getName(distribution)), toCell(points.size()), toCell(static_cast<std::size_t>(seed)),
+        toCell(beachline), toCell(queue), toCell(toNanoseconds(algorithm.getTimings().sweep)),
+        toCell(toNanoseconds(constructEnd - start)), toCell(toNanoseconds(end - constructEnd)), toCell(total),
+        toCell(static_cast<double>(total) / std::max<std::size_t>(points.size(), 1)),
+        toCell(diagram.getVertices().getSize()), toCell(valid)});
+}
+
+// All the combinations of beachlines and event queues on the same inputs
+void runPolicies(const Options& options, Report& report)
+{
+    report.beginTable("policies", {"distribution", "n", "seed", "beachline", "queue", "sweep_ns", "construct_ns",
+        "finalize_ns", "total_ns", "ns_per_site", "vertices", "valid"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                addPolicyRow<Beachline, EventQueue>(options, report, distribution, seed, points, "Beachline",
+                    "EventQueue");
+                addPolicyRow<Beachline, HeapEventQueue>(options, report, distribution, seed, points, "Beachline",
+                    "HeapEventQueue");
+                addPolicyRow<BTreeBeachline, EventQueue>(options, report, distribution, seed, points, "BTreeBeachline",
+                    "EventQueue");
+                addPolicyRow<BTreeBeachline, HeapEventQueue>(options, report, distribution, seed, points,
+                    "BTreeBeachline", "HeapEventQueue");
+            }
+        }
+    }
+}
+
+// Faces without outer component or whose outer component is not a closed cycle
+template<typename T>
+std::size_t countOpenFaces(BasicVoronoiDiagram<T>& diagram)
+{
+    std::size_t nbOpenFaces = 0;
+    std::size_t maxLength = diagram.getHalfEdges().getSize();
+    for (std::size_t i = 0; i < diagram.getNbSites(); ++i)
+    {
+        const typename BasicVoronoiDiagram<T>::HalfEdge* start = diagram.getFace(i)->outerComponent;
+        const typename BasicVoronoiDiagram<T>::HalfEdge* halfEdge = start;
+        std::size_t length = 0;
+        while (halfEdge != nullptr && length <= maxLength)
+        {
+            halfEdge = halfEdge->next;
+            ++length;
+            if (halfEdge == start)
+                break;
+        }
+        if (start == nullptr || halfEdge != start)
+            ++nbOpenFaces;
+    }
+    return nbOpenFaces;
+}
+
+// Sites equal to another one, they are not supported by the construction
+template<typename T>
+std::size_t countDuplicates(std::vector<BasicVector2<T>> points)
+{
+    std::sort(points.begin(), points.end(), [](const BasicVector2<T>& lhs, const BasicVector2<T>& rhs)
+    {
+        return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+    });
+    std::size_t nbDuplicates = 0;
+    for (std::size_t i = 1; i < points.size(); ++i)
+    {
+        if (points[i].x == points[i - 1].x && points[i].y == points[i - 1].y)
+            ++nbDuplicates;
+    }
+    return nbDuplicates;
+}
+
+// Construction and finalization of the points rounded to the scalar type T
+// The inputs where the rounding merges sites are failures without timings
+template<typename T>
+void addPrecisionRow(const Options& options, Report& report, Distribution distribution, std::uint64_t seed,
+    const std::vector<Vector2>& points, const char* scalar)
+{
+    std::vector<BasicVector2<T>> scalarPoints;
+    scalarPoints.reserve(points.size());
+    for (const Vector2& point : points)
+        scalarPoints.emplace_back(static_cast<T>(point.x), static_cast<T>(point.y));
+    BasicBox<T> box{static_cast<T>(BOX.left), static_cast<T>(BOX.bottom), static_cast<T>(BOX.right),
+        static_cast<T>(BOX.top)};
+    std::size_t nbDuplicates = countDuplicates(scalarPoints);
+    if (nbDuplicates > 0)
+    {
+        report.addRow({toCell(getName(distribution)), toCell(points.size()), toCell(static_cast<std::size_t>(seed)),
+            toCell(scalar), "", "", "", "", "", "", "", toCell(nbDuplicates), "", toCell(false), toCell(true)});
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    BasicFortuneAlgorithm<BasicDefaultBeachline<T>, BasicEventQueue<T>> algorithm(scalarPoints);
+    algorithm.construct(options.mode, options.locationMode);
+    auto constructEnd = std::chrono::steady_clock::now();
+    bool valid = algorithm.finalize(box);
+    auto end = std::chrono::steady_clock::now();
+    BasicVoronoiDiagram<T> diagram = algorithm.getDiagram();
+    std::size_t nbOpenFaces = countOpenFaces(diagram);
+    std::size_t total = toNanoseconds(end - start);
+    report.addRow({toCell(getName(distribution)), toCell(points.size()), toCell(static_cast<std::size_t>(seed)),
+        toCell(scalar), toCell(toNanoseconds(algorithm.getTimings().sweep)), toCell(toNanoseconds(constructEnd - start)),
+        toCell(toNanoseconds(end - constructEnd)), toCell(total),
+        toCell(static_cast<double>(total) / std::max<std::size_t>(points.size(), 1)),
+        toCell(diagram.getVertices().getSize()), toCell(diagram.getMemoryUsage()), toCell(nbDuplicates),
+        toCell(nbOpenFaces), toCell(valid), toCell(!valid || nbOpenFaces > 0)});
+}
+
+// The same inputs with float, double and long double coordinates, the failure rate is the mean of failed
+void runPrecision(const Options& options, Report& report)
+{
+    report.beginTable("precision", {"distribution", "n", "seed", "scalar", "sweep_ns", "construct_ns", "finalize_ns",
+        "total_ns", "ns_per_site", "vertices", "diagram_memory", "duplicates", "open_faces", "valid", "failed"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                addPrecisionRow<float>(options, report, distribution, seed, points, "float");
+                addPrecisionRow<double>(options, report, distribution, seed, points, "double");
+                addPrecisionRow<long double>(options, report, distribution, seed, points, "long double");
+            }
+        }
+    }
+}
+
+// Points of the unit square scaled to [0, gridSize] and rounded, without the duplicates
+std::vector<Vector2> snapToIntegers(const std::vector<Vector2>& points, double gridSize)
+{
+    std::vector<Vector2> integerPoints;
+    integerPoints.reserve(points.size());
+    for (const Vector2& point : points)
+        integerPoints.emplace_back(std::round(point.x * gridSize), std::round(point.y * gridSize));
+    std::sort(integerPoints.begin(), integerPoints.end(), [](const Vector2& lhs, const Vector2& rhs)
+    {
+        return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+    });
+    integerPoints.erase(std::unique(integerPoints.begin(), integerPoints.end(), [](const Vector2& lhs, const Vector2& rhs)
+    {
+        return lhs.x == rhs.x && lhs.y == rhs.y;
+    }), integerPoints.end());
+    return integerPoints;
+}
+
+// Construction and finalization of points with integer coordinates with a predicate mode
+// The box is the grid, so the sites on its border have vertices on its sides and corners
+void addIntegerRow(const Options& options, Report& report, Distribution distribution, std::uint64_t seed,
+    const std::vector<Vector2>& points, double gridSize, std::size_t nbDuplicates,
+    FortuneAlgorithm::PredicateMode predicateMode, const char* predicates)
+{
+    auto start = std::chrono::steady_clock::now();
+    FortuneAlgorithm algorithm(points);
+    algorithm.construct(options.mode, options.locationMode, predicateMode);
+    auto constructEnd = std::chrono::steady_clock::now();
+    bool valid = algorithm.finalize(Box{0.0, 0.0, gridSize, gridSize});
+    auto end = std::chrono::steady_clock::now();
+    VoronoiDiagram diagram = algorithm.getDiagram();
+    std::size_t nbOpenFaces = countOpenFaces(diagram);
+    std::size_t total = toNanoseconds(end - start);
+    report.addRow({toCell(getName(distribution)), toCell(points.size()), toCell(static_cast<std::size_t>(seed)),
+        toCell(gridSize), toCell(predicates), toCell(toNanoseconds(algorithm.getTimings().sweep)),
+        toCell(toNanoseconds(constructEnd - start)), toCell(toNanoseconds(end - constructEnd)), toCell(total),
+        toCell(static_cast<double>(total) / std::max<std::size_t>(points.size(), 1)),
+        toCell(diagram.getVertices().getSize()), toCell(nbDuplicates), toCell(nbOpenFaces), toCell(valid),
+        toCell(!valid || nbOpenFaces > 0)});
+}
+
+// The same points snapped to integer grids with the floating and the integer predicates
+// The sites merged by the snapping are removed
+void runInteger(const Options& options, Report& report)
+{
+    report.beginTable("integer", {"distribution", "n", "seed", "grid", "predicates", "sweep_ns", "construct_ns",
+        "finalize_ns", "total_ns", "ns_per_site", "vertices", "duplicates", "open_faces", "valid", "failed"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                for (double gridSize : {COARSE_INTEGER_GRID_SIZE, FINE_INTEGER_GRID_SIZE})
+                {
+                    std::vector<Vector2> integerPoints = snapToIntegers(points, gridSize);
+                    std::size_t nbDuplicates = points.size() - integerPoints.size();
+                    addIntegerRow(options, report, distribution, seed, integerPoints, gridSize, nbDuplicates,
+                        FortuneAlgorithm::PredicateMode::FLOATING, "floating");
+                    addIntegerRow(options, report, distribution, seed, integerPoints, gridSize, nbDuplicates,
+                        FortuneAlgorithm::PredicateMode::INTEGER, "integer");
+                }
+            }
+        }
+    }
+}
+
+// Bounding followed by the intersection versus the fused finalization
+void runFinalize(const Options& options, Report& report)
+{
+    report.beginTable("finalize", {"distribution", "n", "seed", "two_pass_ns", "fused_ns", "speedup", "vertices",
+        "half_edges", "valid"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                // Two passes
+                FortuneAlgorithm twoPassAlgorithm(points);
+                twoPassAlgorithm.construct(options.mode, options.locationMode);
+                auto start = std::chrono::steady_clock::now();
+                bool valid = twoPassAlgorithm.bound(BOUNDING_BOX);
+                VoronoiDiagram twoPassDiagram = twoPassAlgorithm.getDiagram();
+                valid = twoPassDiagram.intersect(BOX) && valid;
+                std::size_t twoPass = toNanoseconds(std::chrono::steady_clock::now() - start);
+                // Fused
+                FortuneAlgorithm fusedAlgorithm(points);
+                fusedAlgorithm.construct(options.mode, options.locationMode);
+                start = std::chrono::steady_clock::now();
+                valid = fusedAlgorithm.finalize(BOX) && valid;
+                VoronoiDiagram fusedDiagram = fusedAlgorithm.getDiagram();
+                std::size_t fused = toNanoseconds(std::chrono::steady_clock::now() - start);
+                report.addRow({toCell(getName(distribution)), toCell(nbPoints), toCell(static_cast<std::size_t>(seed)),
+                    toCell(twoPass), toCell(fused), toCell(static_cast<double>(twoPass) / std::max<std::size_t>(fused, 1)),
+                    toCell(fusedDiagram.getVertices().getSize()), toCell(fusedDiagram.getHalfEdges().getSize()),
+                    toCell(valid)});
+            }
+        }
+    }
+}
+
+double computeArea(const std::vector<Vector2>& vertices)
+{
+    double area = 0.0;
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Vector2& point = vertices[i];
+        const Vector2& nextPoint = vertices[(i + 1) % vertices.size()];
+        area += point.x * nextPoint.y - nextPoint.x * point.y;
+    }
+    return area * 0.5;
+}
+
+// Consume the cells as they are emitted by the sweep instead of building the whole diagram
+void runStream(const Options& options, Report& report)
+{
+    report.beginTable("stream", {"distribution", "n", "seed", "sink", "total_ns", "ns_per_site", "cells", "vertices",
+        "peak_memory", "area", "valid"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                auto addRow = [&](const std::string& sink, std::size_t total, std::size_t nbCells,
+                    std::size_t nbVertices, double area, bool valid)
+                {
+                    std::size_t peakMemory = getPeakMemoryUsage();
+                    report.addRow({toCell(getName(distribution)), toCell(nbPoints),
+                        toCell(static_cast<std::size_t>(seed)), toCell(sink), toCell(total),
+                        toCell(static_cast<double>(total) / std::max<std::size_t>(nbPoints, 1)), toCell(nbCells),
+                        toCell(nbVertices), toCell(peakMemory), toCell(area), toCell(valid)});
+                };
+                // Whole diagram
+                {
+                    resetPeakMemoryUsage();
+                    auto start = std::chrono::steady_clock::now();
+                    FortuneAlgorithm algorithm(points);
+                    algorithm.construct(options.mode, options.locationMode);
+                    bool valid = algorithm.finalize(BOX);
+                    VoronoiDiagram diagram = algorithm.getDiagram();
+                    std::size_t total = toNanoseconds(std::chrono::steady_clock::now() - start);
+                    std::size_t nbCells = 0;
+                    std::size_t nbVertices = 0;
+                    double area = 0.0;
+                    std::vector<Vector2> vertices;
+                    for (std::size_t j = 0; j < diagram.getNbSites(); ++j)
+                    {
+                        const VoronoiDiagram::HalfEdge* firstHalfEdge = diagram.getFace(j)->outerComponent;
+                        const VoronoiDiagram::HalfEdge* halfEdge = firstHalfEdge;
+                        vertices.clear();
+                        while (halfEdge != nullptr)
+                        {
+                            vertices.push_back(halfEdge->origin->point);
+                            halfEdge = halfEdge->next;
+                            if (halfEdge == firstHalfEdge)
+                                break;
+                        }
+                        nbCells += !vertices.empty();
+                        nbVertices += vertices.size();
+                        area += computeArea(vertices);
+                    }
+                    addRow("finalize", total, nbCells, nbVertices, area, valid);
+                }
+                // Callback
+                {
+                    resetPeakMemoryUsage();
+                    std::size_t nbCells = 0;
+                    std::size_t nbVertices = 0;
+                    double area = 0.0;
+                    auto start = std::chrono::steady_clock::now();
+                    FortuneAlgorithm algorithm(points);
+                    bool valid = algorithm.stream(BOX, [&](const FortuneAlgorithm::Cell& cell)
+                    {
+                        nbCells += !cell.vertices.empty();
+                        nbVertices += cell.vertices.size();
+                        area += computeArea(cell.vertices);
+                    }, options.mode, options.locationMode);
+                    std::size_t total = toNanoseconds(std::chrono::steady_clock::now() - start);
+                    addRow("callback", total, nbCells, nbVertices, area, valid);
+                }
+                // Ring buffer drained by another thread
+                {
+                    resetPeakMemoryUsage();
+                    std::size_t nbCells = 0;
+                    std::size_t nbVertices = 0;
+                    double area = 0.0;
+                    auto start = std::chrono::steady_clock::now();
+                    RingBuffer<FortuneAlgorithm::Cell> buffer(RING_CAPACITY);
+                    std::thread consumer([&]()
+                    {
+                        FortuneAlgorithm::Cell cell{};
+                        while (buffer.pop(cell))
+                        {
+                            nbCells += !cell.vertices.empty();
+                            nbVertices += cell.vertices.size();
+                            area += computeArea(cell.vertices);
+                        }
+                    });
+                    FortuneAlgorithm algorithm(points);
+                    bool valid = algorithm.stream(BOX, [&](const FortuneAlgorithm::Cell& cell){ buffer.push(cell); },
+                        options.mode, options.locationMode);
+                    buffer.close();
+                    consumer.join();
+                    std::size_t total = toNanoseconds(std::chrono::steady_clock::now() - start);
+                    addRow("ring", total, nbCells, nbVertices, area, valid);
+                }
+            }
+        }
+    }
+}
+
+// Walk the boundary of every face, return a checksum of their vertices
+double traverseFaces(const FrozenDiagram& diagram)
+{
+    double checksum = 0.0;
+    for (FrozenDiagram::Index face = 0; face < diagram.getNbSites(); ++face)
+    {
+        FrozenDiagram::Index start = diagram.getOuterComponent(face);
+        FrozenDiagram::Index halfEdge = start;
+        while (halfEdge != FrozenDiagram::INVALID_INDEX)
+        {
+            FrozenDiagram::Index origin = diagram.getOrigin(halfEdge);
+            if (origin != FrozenDiagram::INVALID_INDEX)
+                checksum += diagram.getVertexPoint(origin).x;
+            halfEdge = diagram.getNext(halfEdge);
+            if (halfEdge == start)
+                break;
+        }
+    }
+    return checksum;
+}
+
+// Freezing, saving and mapping of a diagram, the first traversal of the mapped diagram takes the page faults
+void runMapped(const Options& options, Report& report)
+{
+    report.beginTable("mapped", {"distribution", "n", "seed", "file_size", "bytes_per_site", "freeze_ns", "save_ns",
+        "load_ns", "first_traversal_ns", "mapped_traversal_ns", "traversal_ns", "matches", "valid"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                FortuneAlgorithm algorithm(points);
+                algorithm.construct(options.mode, options.locationMode);
+                bool valid = algorithm.finalize(BOX);
+                auto start = std::chrono::steady_clock::now();
+                FrozenDiagram diagram = algorithm.getDiagram().freeze();
+                auto freezeEnd = std::chrono::steady_clock::now();
+                diagram.save(MAPPED_DIAGRAM_PATH);
+                auto saveEnd = std::chrono::steady_clock::now();
+                FrozenDiagram mappedDiagram = FrozenDiagram::load(MAPPED_DIAGRAM_PATH);
+                auto loadEnd = std::chrono::steady_clock::now();
+                double firstChecksum = traverseFaces(mappedDiagram);
+                auto firstTraversalEnd = std::chrono::steady_clock::now();
+                double mappedChecksum = traverseFaces(mappedDiagram);
+                auto mappedTraversalEnd = std::chrono::steady_clock::now();
+                double checksum = traverseFaces(diagram);
+                auto traversalEnd = std::chrono::steady_clock::now();
+                std::size_t fileSize = mappedDiagram.getMemoryUsage();
+                bool matches = firstChecksum == checksum && mappedChecksum == checksum &&
+                    mappedDiagram.getNbHalfEdges() == diagram.getNbHalfEdges();
+                std::remove(MAPPED_DIAGRAM_PATH);
+                report.addRow({toCell(getName(distribution)), toCell(nbPoints), toCell(static_cast<std::size_t>(seed)),
+                    toCell(fileSize), toCell(static_cast<double>(fileSize) / std::max<std::size_t>(nbPoints, 1)),
+                    toCell(toNanoseconds(freezeEnd - start)), toCell(toNanoseconds(saveEnd - freezeEnd)),
+                    toCell(toNanoseconds(loadEnd - saveEnd)), toCell(toNanoseconds(firstTraversalEnd - loadEnd)),
+                    toCell(toNanoseconds(mappedTraversalEnd - firstTraversalEnd)),
+                    toCell(toNanoseconds(traversalEnd - mappedTraversalEnd)), toCell(matches), toCell(valid)});
+            }
+        }
+    }
+}
+
+// Compare the cycles of origins of the faces, the half edges may be numbered differently
+bool haveSameFaces(const FrozenDiagram& diagram, const FrozenDiagram& other)
+{
+    if (diagram.getNbSites() != other.getNbSites() || diagram.getNbHalfEdges() != other.getNbHalfEdges())
+        return false;
+    for (FrozenDiagram::Index face = 0; face < diagram.getNbSites(); ++face)
+    {
+        FrozenDiagram::Index start = diagram.getOuterComponent(face);
+        FrozenDiagram::Index halfEdge = start;
+        FrozenDiagram::Index otherStart = other.getOuterComponent(face);
+        FrozenDiagram::Index otherHalfEdge = otherStart;
+        while (halfEdge != FrozenDiagram::INVALID_INDEX && otherHalfEdge != FrozenDiagram::INVALID_INDEX)
+        {
+            if (diagram.getOrigin(halfEdge) != other.getOrigin(otherHalfEdge) ||
+                diagram.getDestination(halfEdge) != other.getDestination(otherHalfEdge))
+                return false;
+            halfEdge = diagram.getNext(halfEdge);
+            otherHalfEdge = other.getNext(otherHalfEdge);
+            if (halfEdge == start)
+                break;
+        }
+        // Both cycles must be closed or open at the same place
+        if ((halfEdge == start) != (otherHalfEdge == otherStart) ||
+            (halfEdge == FrozenDiagram::INVALID_INDEX) != (otherHalfEdge == FrozenDiagram::INVALID_INDEX))
+            return false;
+    }
+    return true;
+}
+
+// Encoding and decoding of frozen diagrams, the throughputs are in MB of frozen arrays per second
+void runCompress(const Options& options, Report& report)
+{
+    report.beginTable("compress", {"distribution", "n", "seed", "bits", "diagram_memory", "frozen_size",
+        "compressed_size", "ratio", "diagram_ratio", "encode_ns", "decode_ns", "encode_mb_per_s", "decode_mb_per_s",
+        "max_error", "matches", "valid"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                FortuneAlgorithm algorithm(points);
+                algorithm.construct(options.mode, options.locationMode);
+                bool valid = algorithm.finalize(BOX);
+                VoronoiDiagram voronoiDiagram = algorithm.getDiagram();
+                std::size_t diagramMemory = voronoiDiagram.getMemoryUsage();
+                FrozenDiagram diagram = voronoiDiagram.freeze();
+                std::size_t frozenSize = diagram.getMemoryUsage();
+                for (int nbBits : QUANTIZATION_NB_BITS)
+                {
+                    std::stringstream stream;
+                    auto start = std::chrono::steady_clock::now();
+                    std::size_t compressedSize = encodeDiagram(diagram, stream, nbBits, BOX);
+                    auto encodeEnd = std::chrono::steady_clock::now();
+                    FrozenDiagram decodedDiagram = decodeDiagram(stream);
+                    auto decodeEnd = std::chrono::steady_clock::now();
+                    double maxError = 0.0;
+                    for (FrozenDiagram::Index j = 0; j < diagram.getNbVertices(); ++j)
+                    {
+                        Vector2 error = decodedDiagram.getVertexPoint(j) - diagram.getVertexPoint(j);
+                        maxError = std::max({maxError, std::abs(error.x), std::abs(error.y)});
+                    }
+                    std::size_t encode = toNanoseconds(encodeEnd - start);
+                    std::size_t decode = toNanoseconds(decodeEnd - encodeEnd);
+                    report.addRow({toCell(getName(distribution)), toCell(nbPoints),
+                        toCell(static_cast<std::size_t>(seed)), toCell(static_cast<std::size_t>(nbBits)),
+                        toCell(diagramMemory), toCell(frozenSize), toCell(compressedSize),
+                        toCell(static_cast<double>(frozenSize) / std::max<std::size_t>(compressedSize, 1)),
+                        toCell(static_cast<double>(diagramMemory) / std::max<std::size_t>(compressedSize, 1)),
+                        toCell(encode), toCell(decode),
+                        toCell(static_cast<double>(frozenSize) * 1e3 / std::max<std::size_t>(encode, 1)),
+                        toCell(static_cast<double>(frozenSize) * 1e3 / std::max<std::size_t>(decode, 1)),
+                        toCell(maxError), toCell(haveSameFaces(diagram, decodedDiagram)), toCell(valid)});
+                }
+            }
+        }
+    }
+}
+
+// Thread scaling of the slab-decomposed construction
+void runParallel(const Options& options, Report& report)
+{
+    report.beginTable("parallel", {"distribution", "n", "seed", "threads", "slabs", "retries", "total_ns", "ns_per_site",
+        "speedup", "valid"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t nbPoints : options.sizes)
+        {
+            for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+            {
+                std::uint64_t seed = options.seed + i;
+                std::vector<Vector2> points = generatePoints(distribution, nbPoints, seed);
+                double reference = 0.0;
+                for (std::size_t nbThreads : options.nbThreads)
+                {
+                    ParallelFortuneAlgorithm algorithm(points, nbThreads);
+                    auto start = std::chrono::steady_clock::now();
+                    bool valid = algorithm.construct(BOX);
+                    std::size_t total = toNanoseconds(std::chrono::steady_clock::now() - start);
+                    if (reference == 0.0)
+                        reference = static_cast<double>(total);
+                    report.addRow({toCell(getName(distribution)), toCell(nbPoints), toCell(static_cast<std::size_t>(seed)),
+                        toCell(nbThreads), toCell(algorithm.getNbSlabs()), toCell(algorithm.getNbRetries()), toCell(total),
+                        toCell(static_cast<double>(total) / std::max<std::size_t>(nbPoints, 1)),
+                        toCell(reference / std::max<std::size_t>(total, 1)), toCell(valid)});
+                }
+            }
+        }
+    }
+}
+
+// Throughput of the batch construction of many small diagrams
+void runBatch(const Options& options, Report& report)
+{
+    report.beginTable("batch", {"distribution", "diagrams", "sites", "seed", "threads", "total_ns", "diagrams_per_second",
+        "invalid"});
+    for (Distribution distribution : options.distributions)
+    {
+        for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+        {
+            std::uint64_t seed = options.seed + i;
+            RandomGenerator generator(seed);
+            std::vector<std::vector<Vector2>> points;
+            std::size_t nbSites = 0;
+            for (std::size_t j = 0; j < options.batchSize; ++j)
+            {
+                // Drawn in sequence, the order of evaluation of arguments is unspecified
+                std::size_t size = MIN_BATCH_DIAGRAM_SIZE +
+                    generator.getIndex(MAX_BATCH_DIAGRAM_SIZE - MIN_BATCH_DIAGRAM_SIZE + 1);
+                std::uint64_t diagramSeed = generator.getBits();
+                points.push_back(generatePoints(distribution, size, diagramSeed));
+                nbSites += points.back().size();
+            }
+            std::vector<Box> boxes(points.size(), BOX);
+            for (std::size_t nbThreads : options.nbThreads)
+            {
+                BatchFortuneAlgorithm algorithm(nbThreads);
+                algorithm.construct(points, boxes);
+                report.addRow({toCell(getName(distribution)), toCell(points.size()), toCell(nbSites),
+                    toCell(static_cast<std::size_t>(seed)), toCell(nbThreads), toCell(toNanoseconds(algorithm.getDuration())),
+                    toCell(algorithm.getThroughput()), toCell(algorithm.getNbInvalidDiagrams())});
+            }
+        }
+    }
+}
+
+// Event queue micro-benchmark
+void runQueue(const Options& options, Report& report)
+{
+    report.beginTable("queue", {"queue", "n", "seed", "operations", "total_ns", "ns_per_operation"});
+    for (std::size_t nbEvents : options.sizes)
+    {
+        for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+        {
+            std::uint64_t seed = options.seed + i;
+            QueueTimings timings = benchmarkQueues(nbEvents, seed);
+            auto addRow = [&](const char* name, std::chrono::nanoseconds duration)
+            {
+                report.addRow({toCell(name), toCell(nbEvents), toCell(static_cast<std::size_t>(seed)),
+                    toCell(timings.nbOperations), toCell(toNanoseconds(duration)),
+                    toCell(static_cast<double>(duration.count()) / std::max<std::size_t>(timings.nbOperations, 1))});
+            };
+            addRow("EventQueue", timings.eventQueue);
+            addRow("PriorityQueue", timings.priorityQueue);
+        }
+    }
+}
+
+// Beachline site location micro-benchmark, n is the number of arcs
+void runLocate(const Options& options, Report& report)
+{
+    report.beginTable("locate", {"beachline", "n", "seed", "locations", "total_ns", "ns_per_location", "mismatches"});
+    for (std::size_t nbArcs : options.sizes)
+    {
+        for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+        {
+            std::uint64_t seed = options.seed + i;
+            LocateTimings timings = benchmarkLocations(nbArcs, NB_LOCATIONS, seed);
+            auto addRow = [&](const char* name, std::chrono::nanoseconds duration, std::size_t nbMismatches)
+            {
+                report.addRow({toCell(name), toCell(nbArcs), toCell(static_cast<std::size_t>(seed)),
+                    toCell(timings.nbLocations), toCell(toNanoseconds(duration)),
+                    toCell(static_cast<double>(duration.count()) / std::max<std::size_t>(timings.nbLocations, 1)),
+                    toCell(nbMismatches)});
+            };
+            addRow("Beachline", timings.redBlackTree, timings.nbRedBlackTreeMismatches);
+            addRow("BTreeBeachline", timings.bTree, timings.nbBTreeMismatches);
+            addRow("Reference", timings.reference, 0);
+        }
+    }
+}
+
+// Beachline insertion, replacement and removal micro-benchmark, n is the number of arcs
+void runUpdate(const Options& options, Report& report)
+{
+    report.beginTable("update", {"beachline", "n", "seed", "operations", "total_ns", "ns_per_operation"});
+    for (std::size_t nbArcs : options.sizes)
+    {
+        for (std::size_t i = 0; i < options.nbRepetitions; ++i)
+        {
+            std::uint64_t seed = options.seed + i;
+            UpdateTimings timings = benchmarkUpdates(nbArcs, seed);
+            auto addRow = [&](const char* name, std::chrono::nanoseconds duration)
+            {
+                report.addRow({toCell(name), toCell(nbArcs), toCell(static_cast<std::size_t>(seed)),
+                    toCell(timings.nbOperations), toCell(toNanoseconds(duration)),
+                    toCell(static_cast<double>(duration.count()) / std::max<std::size_t>(timings.nbOperations, 1))});
+            };
+            addRow("Beachline", timings.redBlackTree);
+            addRow("BTreeBeachline", timings.bTree);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        Options options = parseOptions(argc, argv);
+        std::ofstream file;
+        if (!options.output.empty())
+        {
+            file.open(options.output);
+            if (!file)
+                throw std::runtime_error("Impossible to open " + options.output);
+        }
+        Report report(options.output.empty() ? std::cout : file, options.format);
+        for (const std::string& suite : options.suites)
+        {
+            if (suite == "phases")
+                runPhases(options, report);
+            else if (suite == "policies")
+                runPolicies(options, report);
+            else if (suite == "precision")
+                runPrecision(options, report);
+            else if (suite == "integer")
+                runInteger(options, report);
+            else if (suite == "finalize")
+                runFinalize(options, report);
+            else if (suite == "stream")
+                runStream(options, report);
+            else if (suite == "mapped")
+                runMapped(options, report);
+            else if (suite == "compress")
+                runCompress(options, report);
+            else if (suite == "parallel")
+                runParallel(options, report);
+            else if (suite == "batch")
+                runBatch(options, report);
+            else if (suite == "queue")
+                runQueue(options, report);
+            else if (suite == "locate")
+                runLocate(options, report);
+            else if (suite == "update")
+                runUpdate(options, report);
+            else
+                throw std::invalid_argument("Unknown suite: " + suite);
+        }
+        report.finish();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n' << USAGE;
+        return 1;
+    }
+    return 0;
+}
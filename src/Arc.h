@@ -17,28 +17,33 @@
 
 #pragma once
 
+// STL
+#include <cstdint>
 // My includes
 #include "VoronoiDiagram.h"
+#include "EventQueue.h"
 
-class Event;
-
-struct Arc
+template<typename T>
+struct BasicArc
 {
     enum class Color{RED, BLACK};
 
     // Hierarchy
-    Arc* parent;
-    Arc* left;
-    Arc* right;
+    BasicArc* parent;
+    BasicArc* left;
+    BasicArc* right;
     // Diagram
-    VoronoiDiagram::Site* site;
-    VoronoiDiagram::HalfEdge* leftHalfEdge;
-    VoronoiDiagram::HalfEdge* rightHalfEdge;
-    Event* event;
+    typename BasicVoronoiDiagram<T>::Site* site;
+    typename BasicVoronoiDiagram<T>::HalfEdge* leftHalfEdge;
+    typename BasicVoronoiDiagram<T>::HalfEdge* rightHalfEdge;
+    typename BasicEventQueue<T>::Handle event;
     // Optimizations
-    Arc* prev;
-    Arc* next;
+    BasicArc* prev;
+    BasicArc* next;
     // Only for balancing
     Color color;
+    // Leaf containing the arc, only used by BTreeBeachline
+    std::uint32_t leaf;
 };
 
+using Arc = BasicArc<double>;
@@ -0,0 +1,644 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BTreeBeachline.h"
+// STL
+#include <ostream>
+// My includes
+#include "IntegerPredicates.h"
+
+template<typename T>
+constexpr std::size_t BasicBTreeBeachline<T>::LEAF_CAPACITY;
+template<typename T>
+constexpr std::size_t BasicBTreeBeachline<T>::INNER_CAPACITY;
+template<typename T>
+constexpr std::size_t BasicBTreeBeachline<T>::LEAF_MIN_SIZE;
+template<typename T>
+constexpr std::size_t BasicBTreeBeachline<T>::INNER_MIN_SIZE;
+template<typename T>
+constexpr std::uint32_t BasicBTreeBeachline<T>::NO_NODE;
+
+template<typename T>
+BasicBTreeBeachline<T>::BasicBTreeBeachline() : mNil(mArcPool.create()), mRoot(NO_NODE), mHeight(0), mIntegerSites(false)
+{
+
+}
+
+// The arcs are released in bulk with the slabs of the pool
+template<typename T>
+BasicBTreeBeachline<T>::~BasicBTreeBeachline() = default;
+
+template<typename T>
+void BasicBTreeBeachline<T>::reset()
+{
+    mArcPool.clear();
+    mNil = mArcPool.create();
+    mLeaves.clear();
+    mInners.clear();
+    mFreeLeaves.clear();
+    mFreeInners.clear();
+    mRoot = NO_NODE;
+    mHeight = 0;
+    FORTUNE_STATISTICS_ONLY(mStatistics = Statistics{});
+}
+
+template<typename T>
+BasicArc<T>* BasicBTreeBeachline<T>::createArc(typename VoronoiDiagram::Site* site)
+{
+    return mArcPool.create(nullptr, nullptr, nullptr, site, nullptr, nullptr, BasicEventQueue<T>::INVALID_HANDLE, mNil, mNil,
+        Arc::Color::BLACK, NO_NODE);
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::deleteArc(Arc* arc)
+{
+    mArcPool.destroy(arc);
+}
+
+template<typename T>
+bool BasicBTreeBeachline<T>::isEmpty() const
+{
+    return mRoot == NO_NODE;
+}
+
+template<typename T>
+bool BasicBTreeBeachline<T>::isNil(const Arc* x) const
+{
+    return x == mNil;
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::setRoot(Arc* x)
+{
+    mRoot = createLeaf(NO_NODE);
+    mHeight = 0;
+    insertArc(mRoot, 0, x);
+}
+
+template<typename T>
+BasicArc<T>* BasicBTreeBeachline<T>::getLeftmostArc() const
+{
+    std::uint32_t node = mRoot;
+    for (std::size_t level = mHeight; level > 0; --level)
+        node = mInners[node].children[0];
+    return mLeaves[node].arcs[0];
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::setIntegerSites(bool integerSites)
+{
+    mIntegerSites = integerSites;
+}
+
+template<typename T>
+BasicArc<T>* BasicBTreeBeachline<T>::locateArcAbove(const Vector2& point, T l) const
+{
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocations);
+    FORTUNE_STATISTICS_ONLY(mStatistics.nbRootLocationSteps += mHeight + 1);
+    // In each node, binary search of the first element whose right breakpoint is not on the left of the point
+    std::uint32_t node = mRoot;
+    for (std::size_t level = mHeight; level > 0; --level)
+    {
+        FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocationSteps);
+        const Inner& inner = mInners[node];
+        std::size_t low = 0;
+        std::size_t high = inner.nbChildren - 1;
+        while (low < high)
+        {
+            std::size_t middle = (low + high) / 2;
+            if (compareWithBreakpoint(inner.lastX[middle], inner.lastY[middle], inner.firstX[middle + 1],
+                inner.firstY[middle + 1], point.x, l, mIntegerSites) > 0)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        node = inner.children[low];
+    }
+    return locateArcInLeaf(node, point, l);
+}
+
+template<typename T>
+BasicArc<T>* BasicBTreeBeachline<T>::locateArcAbove(const Vector2& point, T l, Arc* hint) const
+{
+    // Only the leaf of the hint is tried, the point must be strictly inside its range so that the result is the same
+    // as with a descent from the root when the point is on a breakpoint
+    const Leaf& leaf = mLeaves[hint->leaf];
+    const Arc* first = leaf.arcs[0];
+    const Arc* last = leaf.arcs[leaf.nbArcs - 1];
+    bool isInside = isNil(first->prev) ||
+        compareWithBreakpoint(first->prev->site->point, first->site->point, point.x, l, mIntegerSites) > 0;
+    isInside = isInside && (isNil(last->next) ||
+        compareWithBreakpoint(last->site->point, last->next->site->point, point.x, l, mIntegerSites) < 0);
+    if (isInside)
+    {
+        FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocations);
+        FORTUNE_STATISTICS_ONLY(++mStatistics.nbHintedLocations);
+        FORTUNE_STATISTICS_ONLY(mStatistics.nbRootLocationSteps += mHeight + 1);
+        return locateArcInLeaf(hint->leaf, point, l);
+    }
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbHintedLocations);
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocationSteps);
+    return locateArcAbove(point, l);
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::insertBefore(Arc* x, Arc* y)
+{
+    insertArc(x->leaf, getArcPosition(x), y);
+    // Set the pointers
+    y->prev = x->prev;
+    if (!isNil(y->prev))
+        y->prev->next = y;
+    y->next = x;
+    x->prev = y;
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::insertAfter(Arc* x, Arc* y)
+{
+    insertArc(x->leaf, getArcPosition(x) + 1, y);
+    // Set the pointers
+    y->next = x->next;
+    if (!isNil(y->next))
+        y->next->prev = y;
+    y->prev = x;
+    x->next = y;
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::replace(Arc* x, Arc* y)
+{
+    std::uint32_t leafIndex = x->leaf;
+    Leaf& leaf = mLeaves[leafIndex];
+    std::size_t i = getArcPosition(x);
+    leaf.arcs[i] = y;
+    leaf.x[i] = y->site->point.x;
+    leaf.y[i] = y->site->point.y;
+    y->leaf = leafIndex;
+    if (i == 0 || i + 1 == leaf.nbArcs)
+        updateBounds(leafIndex, true);
+    // Set the pointers
+    y->prev = x->prev;
+    y->next = x->next;
+    if (!isNil(y->prev))
+        y->prev->next = y;
+    if (!isNil(y->next))
+        y->next->prev = y;
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::remove(Arc* z)
+{
+    removeArc(z->leaf, getArcPosition(z));
+    // Update next and prev
+    if (!isNil(z->prev))
+        z->prev->next = z->next;
+    if (!isNil(z->next))
+        z->next->prev = z->prev;
+}
+
+template<typename T>
+std::ostream& BasicBTreeBeachline<T>::print(std::ostream& os) const
+{
+    if (isEmpty())
+        return os;
+    Arc* arc = getLeftmostArc();
+    while (!isNil(arc))
+    {
+        os << arc->site->index << ' ';
+        arc = arc->next;
+    }
+    return os;
+}
+
+template<typename T>
+std::size_t BasicBTreeBeachline<T>::getNbArcs() const
+{
+    return mArcPool.getNbElements() - 1; // Do not count Nil
+}
+
+template<typename T>
+std::size_t BasicBTreeBeachline<T>::getNbArcAllocations() const
+{
+    return mArcPool.getNbAllocations() - 1;
+}
+
+template<typename T>
+std::size_t BasicBTreeBeachline<T>::getNbArcSlabs() const
+{
+    return mArcPool.getNbSlabs();
+}
+
+template<typename T>
+std::size_t BasicBTreeBeachline<T>::getHeight() const
+{
+    return mHeight;
+}
+
+#ifdef FORTUNE_STATISTICS
+template<typename T>
+const Statistics& BasicBTreeBeachline<T>::getStatistics() const
+{
+    return mStatistics;
+}
+#endif
+
+template<typename T>
+std::uint32_t BasicBTreeBeachline<T>::createLeaf(std::uint32_t parent)
+{
+    std::uint32_t leaf;
+    if (!mFreeLeaves.empty())
+    {
+        leaf = mFreeLeaves.back();
+        mFreeLeaves.pop_back();
+    }
+    else
+    {
+        leaf = static_cast<std::uint32_t>(mLeaves.size());
+        mLeaves.emplace_back();
+    }
+    mLeaves[leaf].parent = parent;
+    mLeaves[leaf].nbArcs = 0;
+    return leaf;
+}
+
+template<typename T>
+std::uint32_t BasicBTreeBeachline<T>::createInner(std::uint32_t parent, bool hasLeafChildren)
+{
+    std::uint32_t inner;
+    if (!mFreeInners.empty())
+    {
+        inner = mFreeInners.back();
+        mFreeInners.pop_back();
+    }
+    else
+    {
+        inner = static_cast<std::uint32_t>(mInners.size());
+        mInners.emplace_back();
+    }
+    mInners[inner].parent = parent;
+    mInners[inner].nbChildren = 0;
+    mInners[inner].hasLeafChildren = hasLeafChildren;
+    return inner;
+}
+
+template<typename T>
+std::uint32_t& BasicBTreeBeachline<T>::getParent(std::uint32_t node, bool isLeaf)
+{
+    return isLeaf ? mLeaves[node].parent : mInners[node].parent;
+}
+
+template<typename T>
+std::size_t BasicBTreeBeachline<T>::getSize(std::uint32_t node, bool isLeaf) const
+{
+    return isLeaf ? mLeaves[node].nbArcs : mInners[node].nbChildren;
+}
+
+template<typename T>
+std::size_t BasicBTreeBeachline<T>::getChildPosition(std::uint32_t inner, std::uint32_t child) const
+{
+    const Inner& node = mInners[inner];
+    std::size_t i = 0;
+    while (node.children[i] != child)
+        ++i;
+    return i;
+}
+
+template<typename T>
+BasicArc<T>* BasicBTreeBeachline<T>::locateArcInLeaf(std::uint32_t leafIndex, const Vector2& point, T l) const
+{
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocationSteps);
+    const Leaf& leaf = mLeaves[leafIndex];
+    std::size_t low = 0;
+    std::size_t high = leaf.nbArcs - 1;
+    while (low < high)
+    {
+        std::size_t middle = (low + high) / 2;
+        if (compareWithBreakpoint(leaf.x[middle], leaf.y[middle], leaf.x[middle + 1], leaf.y[middle + 1], point.x, l,
+            mIntegerSites) > 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return leaf.arcs[low];
+}
+
+template<typename T>
+std::size_t BasicBTreeBeachline<T>::getArcPosition(const Arc* arc) const
+{
+    const Leaf& leaf = mLeaves[arc->leaf];
+    std::size_t i = 0;
+    while (leaf.arcs[i] != arc)
+        ++i;
+    return i;
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::updateBounds(std::uint32_t node, bool isLeaf)
+{
+    // The bounds of the ancestors change as long as the node is the first or the last child of its parent
+    std::uint32_t parent = getParent(node, isLeaf);
+    while (parent != NO_NODE)
+    {
+        std::size_t i = getChildPosition(parent, node);
+        setBounds(parent, i);
+        if (i != 0 && i + 1 != mInners[parent].nbChildren)
+            break;
+        node = parent;
+        parent = mInners[parent].parent;
+    }
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::setBounds(std::uint32_t inner, std::size_t i)
+{
+    Inner& node = mInners[inner];
+    std::uint32_t child = node.children[i];
+    if (node.hasLeafChildren)
+    {
+        const Leaf& leaf = mLeaves[child];
+        node.firstX[i] = leaf.x[0];
+        node.firstY[i] = leaf.y[0];
+        node.lastX[i] = leaf.x[leaf.nbArcs - 1];
+        node.lastY[i] = leaf.y[leaf.nbArcs - 1];
+    }
+    else
+    {
+        const Inner& childNode = mInners[child];
+        node.firstX[i] = childNode.firstX[0];
+        node.firstY[i] = childNode.firstY[0];
+        node.lastX[i] = childNode.lastX[childNode.nbChildren - 1];
+        node.lastY[i] = childNode.lastY[childNode.nbChildren - 1];
+    }
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::insertArc(std::uint32_t leaf, std::size_t i, Arc* arc)
+{
+    if (mLeaves[leaf].nbArcs == LEAF_CAPACITY)
+    {
+        std::uint32_t right = split(leaf, true);
+        std::size_t leftSize = mLeaves[leaf].nbArcs;
+        if (i > leftSize)
+        {
+            leaf = right;
+            i -= leftSize;
+        }
+    }
+    Leaf& node = mLeaves[leaf];
+    for (std::size_t j = node.nbArcs; j > i; --j)
+    {
+        node.arcs[j] = node.arcs[j - 1];
+        node.x[j] = node.x[j - 1];
+        node.y[j] = node.y[j - 1];
+    }
+    node.arcs[i] = arc;
+    node.x[i] = arc->site->point.x;
+    node.y[i] = arc->site->point.y;
+    ++node.nbArcs;
+    arc->leaf = leaf;
+    if (i == 0 || i + 1 == node.nbArcs)
+        updateBounds(leaf, true);
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::insertChild(std::uint32_t inner, std::size_t i, std::uint32_t child)
+{
+    if (mInners[inner].nbChildren == INNER_CAPACITY)
+    {
+        std::uint32_t right = split(inner, false);
+        std::size_t leftSize = mInners[inner].nbChildren;
+        if (i > leftSize)
+        {
+            inner = right;
+            i -= leftSize;
+        }
+    }
+    Inner& node = mInners[inner];
+    for (std::size_t j = node.nbChildren; j > i; --j)
+    {
+        node.children[j] = node.children[j - 1];
+        node.firstX[j] = node.firstX[j - 1];
+        node.firstY[j] = node.firstY[j - 1];
+        node.lastX[j] = node.lastX[j - 1];
+        node.lastY[j] = node.lastY[j - 1];
+    }
+    node.children[i] = child;
+    ++node.nbChildren;
+    getParent(child, node.hasLeafChildren) = inner;
+    setBounds(inner, i);
+    if (i == 0 || i + 1 == node.nbChildren)
+        updateBounds(inner, false);
+}
+
+template<typename T>
+std::uint32_t BasicBTreeBeachline<T>::split(std::uint32_t node, bool isLeaf)
+{
+    // Move the second half of the elements in a new node on the right
+    std::uint32_t parent = getParent(node, isLeaf);
+    std::uint32_t right;
+    if (isLeaf)
+    {
+        right = createLeaf(parent);
+        Leaf& leftLeaf = mLeaves[node];
+        Leaf& rightLeaf = mLeaves[right];
+        std::size_t half = leftLeaf.nbArcs / 2;
+        for (std::size_t j = half; j < leftLeaf.nbArcs; ++j)
+        {
+            rightLeaf.arcs[j - half] = leftLeaf.arcs[j];
+            rightLeaf.x[j - half] = leftLeaf.x[j];
+            rightLeaf.y[j - half] = leftLeaf.y[j];
+            leftLeaf.arcs[j]->leaf = right;
+        }
+        rightLeaf.nbArcs = static_cast<std::uint32_t>(leftLeaf.nbArcs - half);
+        leftLeaf.nbArcs = static_cast<std::uint32_t>(half);
+    }
+    else
+    {
+        right = createInner(parent, mInners[node].hasLeafChildren);
+        Inner& leftInner = mInners[node];
+        Inner& rightInner = mInners[right];
+        std::size_t half = leftInner.nbChildren / 2;
+        for (std::size_t j = half; j < leftInner.nbChildren; ++j)
+        {
+            rightInner.children[j - half] = leftInner.children[j];
+            rightInner.firstX[j - half] = leftInner.firstX[j];
+            rightInner.firstY[j - half] = leftInner.firstY[j];
+            rightInner.lastX[j - half] = leftInner.lastX[j];
+            rightInner.lastY[j - half] = leftInner.lastY[j];
+            getParent(leftInner.children[j], leftInner.hasLeafChildren) = right;
+        }
+        rightInner.nbChildren = static_cast<std::uint32_t>(leftInner.nbChildren - half);
+        leftInner.nbChildren = static_cast<std::uint32_t>(half);
+    }
+    // Add the new node to the parent
+    if (parent == NO_NODE)
+        growRoot(node, right, isLeaf);
+    else
+    {
+        updateBounds(node, isLeaf);
+        insertChild(parent, getChildPosition(parent, node) + 1, right);
+    }
+    return right;
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::growRoot(std::uint32_t left, std::uint32_t right, bool isLeaf)
+{
+    std::uint32_t root = createInner(NO_NODE, isLeaf);
+    Inner& inner = mInners[root];
+    inner.children[0] = left;
+    inner.children[1] = right;
+    inner.nbChildren = 2;
+    getParent(left, isLeaf) = root;
+    getParent(right, isLeaf) = root;
+    setBounds(root, 0);
+    setBounds(root, 1);
+    mRoot = root;
+    ++mHeight;
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::removeArc(std::uint32_t leaf, std::size_t i)
+{
+    Leaf& node = mLeaves[leaf];
+    --node.nbArcs;
+    for (std::size_t j = i; j < node.nbArcs; ++j)
+    {
+        node.arcs[j] = node.arcs[j + 1];
+        node.x[j] = node.x[j + 1];
+        node.y[j] = node.y[j + 1];
+    }
+    if (node.nbArcs == 0)
+    {
+        // Remove the empty leaf
+        if (node.parent == NO_NODE)
+            mRoot = NO_NODE;
+        else
+            removeChild(node.parent, getChildPosition(node.parent, leaf));
+        mFreeLeaves.push_back(leaf);
+        return;
+    }
+    if (i == 0 || i == node.nbArcs)
+        updateBounds(leaf, true);
+    rebalance(leaf, true);
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::removeChild(std::uint32_t inner, std::size_t i)
+{
+    Inner& node = mInners[inner];
+    --node.nbChildren;
+    for (std::size_t j = i; j < node.nbChildren; ++j)
+    {
+        node.children[j] = node.children[j + 1];
+        node.firstX[j] = node.firstX[j + 1];
+        node.firstY[j] = node.firstY[j + 1];
+        node.lastX[j] = node.lastX[j + 1];
+        node.lastY[j] = node.lastY[j + 1];
+    }
+    if (node.nbChildren == 0)
+    {
+        // Remove the empty inner node, the root always has at least two children
+        removeChild(node.parent, getChildPosition(node.parent, inner));
+        mFreeInners.push_back(inner);
+        return;
+    }
+    if (i == 0 || i == node.nbChildren)
+        updateBounds(inner, false);
+    rebalance(inner, false);
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::rebalance(std::uint32_t node, bool isLeaf)
+{
+    if (node == mRoot)
+    {
+        shrinkRoot();
+        return;
+    }
+    std::size_t size = getSize(node, isLeaf);
+    std::size_t capacity = isLeaf ? LEAF_CAPACITY : INNER_CAPACITY;
+    if (size >= (isLeaf ? LEAF_MIN_SIZE : INNER_MIN_SIZE))
+        return;
+    // Merge with a sibling if they fit in one node
+    std::uint32_t parent = getParent(node, isLeaf);
+    const Inner& parentNode = mInners[parent];
+    std::size_t i = getChildPosition(parent, node);
+    if (i > 0 && getSize(parentNode.children[i - 1], isLeaf) + size <= capacity)
+        merge(parentNode.children[i - 1], node, isLeaf);
+    else if (i + 1 < parentNode.nbChildren && size + getSize(parentNode.children[i + 1], isLeaf) <= capacity)
+        merge(node, parentNode.children[i + 1], isLeaf);
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::merge(std::uint32_t left, std::uint32_t right, bool isLeaf)
+{
+    // Move the elements of right at the end of left
+    if (isLeaf)
+    {
+        Leaf& leftLeaf = mLeaves[left];
+        Leaf& rightLeaf = mLeaves[right];
+        for (std::size_t j = 0; j < rightLeaf.nbArcs; ++j)
+        {
+            leftLeaf.arcs[leftLeaf.nbArcs + j] = rightLeaf.arcs[j];
+            leftLeaf.x[leftLeaf.nbArcs + j] = rightLeaf.x[j];
+            leftLeaf.y[leftLeaf.nbArcs + j] = rightLeaf.y[j];
+            rightLeaf.arcs[j]->leaf = left;
+        }
+        leftLeaf.nbArcs += rightLeaf.nbArcs;
+        mFreeLeaves.push_back(right);
+    }
+    else
+    {
+        Inner& leftInner = mInners[left];
+        Inner& rightInner = mInners[right];
+        for (std::size_t j = 0; j < rightInner.nbChildren; ++j)
+        {
+            leftInner.children[leftInner.nbChildren + j] = rightInner.children[j];
+            leftInner.firstX[leftInner.nbChildren + j] = rightInner.firstX[j];
+            leftInner.firstY[leftInner.nbChildren + j] = rightInner.firstY[j];
+            leftInner.lastX[leftInner.nbChildren + j] = rightInner.lastX[j];
+            leftInner.lastY[leftInner.nbChildren + j] = rightInner.lastY[j];
+            getParent(rightInner.children[j], rightInner.hasLeafChildren) = left;
+        }
+        leftInner.nbChildren += rightInner.nbChildren;
+        mFreeInners.push_back(right);
+    }
+    // Remove right from the parent
+    std::uint32_t parent = getParent(left, isLeaf);
+    updateBounds(left, isLeaf);
+    removeChild(parent, getChildPosition(parent, right));
+}
+
+template<typename T>
+void BasicBTreeBeachline<T>::shrinkRoot()
+{
+    // An inner root with a single child is replaced by its child
+    while (mHeight > 0 && mInners[mRoot].nbChildren == 1)
+    {
+        std::uint32_t child = mInners[mRoot].children[0];
+        mFreeInners.push_back(mRoot);
+        mRoot = child;
+        --mHeight;
+        getParent(mRoot, mHeight == 0) = NO_NODE;
+    }
+}
+
+template class BasicBTreeBeachline<float>;
+template class BasicBTreeBeachline<double>;
+template class BasicBTreeBeachline<long double>;
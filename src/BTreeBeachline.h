@@ -0,0 +1,168 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+// My includes
+#include "Vector2.h"
+#include "VoronoiDiagram.h"
+#include "MemoryPool.h"
+#include "Arc.h"
+#include "Statistics.h"
+
+// Beachline stored in a B+ tree whose nodes are referred to by indices
+// The leaves contain the arcs in order with their sites stored inline and the inner nodes the sites of the first
+// and last arcs of their children, so that locateArcAbove does not dereference the arcs
+// The arcs keep their prev and next pointers and the interface is the same as Beachline
+template<typename T>
+class BasicBTreeBeachline
+{
+public:
+    using Scalar = T;
+    using Vector2 = BasicVector2<T>;
+    using VoronoiDiagram = BasicVoronoiDiagram<T>;
+    using Arc = BasicArc<T>;
+
+    BasicBTreeBeachline();
+    ~BasicBTreeBeachline();
+
+    // Remove copy and move operations
+    BasicBTreeBeachline(const BasicBTreeBeachline&) = delete;
+    BasicBTreeBeachline& operator=(const BasicBTreeBeachline&) = delete;
+    BasicBTreeBeachline(BasicBTreeBeachline&&) = delete;
+    BasicBTreeBeachline& operator=(BasicBTreeBeachline&&) = delete;
+
+    // Remove all the arcs but keep the memory
+    void reset();
+
+    Arc* createArc(typename VoronoiDiagram::Site* site);
+    void deleteArc(Arc* arc);
+
+    bool isEmpty() const;
+    bool isNil(const Arc* x) const;
+    void setRoot(Arc* x); // Only valid if the beachline is empty
+    Arc* getLeftmostArc() const;
+    // Locate the arcs with the exact predicates of IntegerPredicates.h, the sites must have integer coordinates
+    void setIntegerSites(bool integerSites);
+
+    Arc* locateArcAbove(const Vector2& point, T l) const;
+    // Search in the leaf of hint first, faster if the point is close to it, the result is the same
+    Arc* locateArcAbove(const Vector2& point, T l, Arc* hint) const;
+    void insertBefore(Arc* x, Arc* y);
+    void insertAfter(Arc* x, Arc* y);
+    void replace(Arc* x, Arc* y);
+    void remove(Arc* z);
+
+    std::ostream& print(std::ostream& os) const;
+
+    // Memory
+    std::size_t getNbArcs() const;
+    std::size_t getNbArcAllocations() const;
+    std::size_t getNbArcSlabs() const;
+    std::size_t getHeight() const; // 0 if the root is a leaf
+
+#ifdef FORTUNE_STATISTICS
+    // Statistics since the last reset, only the location counters are set, a step is a visited node
+    const Statistics& getStatistics() const;
+#endif
+
+private:
+    static constexpr std::size_t LEAF_CAPACITY = 16;
+    static constexpr std::size_t INNER_CAPACITY = 16;
+    // A node with fewer elements is merged with a sibling if they fit in one node
+    static constexpr std::size_t LEAF_MIN_SIZE = LEAF_CAPACITY / 4;
+    static constexpr std::size_t INNER_MIN_SIZE = INNER_CAPACITY / 4;
+    static constexpr std::uint32_t NO_NODE = std::numeric_limits<std::uint32_t>::max();
+
+    struct Leaf
+    {
+        std::uint32_t parent;
+        std::uint32_t nbArcs;
+        std::array<T, LEAF_CAPACITY> x;
+        std::array<T, LEAF_CAPACITY> y;
+        std::array<Arc*, LEAF_CAPACITY> arcs;
+    };
+
+    struct Inner
+    {
+        std::uint32_t parent;
+        std::uint32_t nbChildren;
+        bool hasLeafChildren;
+        // Sites of the first and last arcs of each child
+        std::array<T, INNER_CAPACITY> firstX;
+        std::array<T, INNER_CAPACITY> firstY;
+        std::array<T, INNER_CAPACITY> lastX;
+        std::array<T, INNER_CAPACITY> lastY;
+        std::array<std::uint32_t, INNER_CAPACITY> children;
+    };
+
+    MemoryPool<Arc> mArcPool;
+    Arc* mNil;
+    std::vector<Leaf> mLeaves;
+    std::vector<Inner> mInners;
+    std::vector<std::uint32_t> mFreeLeaves;
+    std::vector<std::uint32_t> mFreeInners;
+    std::uint32_t mRoot;
+    std::size_t mHeight;
+    bool mIntegerSites;
+#ifdef FORTUNE_STATISTICS
+    mutable Statistics mStatistics;
+#endif
+
+    // Nodes
+    std::uint32_t createLeaf(std::uint32_t parent);
+    std::uint32_t createInner(std::uint32_t parent, bool hasLeafChildren);
+    std::uint32_t& getParent(std::uint32_t node, bool isLeaf);
+    std::size_t getSize(std::uint32_t node, bool isLeaf) const;
+    std::size_t getChildPosition(std::uint32_t inner, std::uint32_t child) const;
+    std::size_t getArcPosition(const Arc* arc) const;
+    Arc* locateArcInLeaf(std::uint32_t leaf, const Vector2& point, T l) const;
+
+    // Sites of the first and last arcs of the children
+    void updateBounds(std::uint32_t node, bool isLeaf);
+    void setBounds(std::uint32_t inner, std::size_t i);
+
+    // Insertion
+    void insertArc(std::uint32_t leaf, std::size_t i, Arc* arc);
+    void insertChild(std::uint32_t inner, std::size_t i, std::uint32_t child);
+    std::uint32_t split(std::uint32_t node, bool isLeaf);
+    void growRoot(std::uint32_t left, std::uint32_t right, bool isLeaf);
+
+    // Removal
+    void removeArc(std::uint32_t leaf, std::size_t i);
+    void removeChild(std::uint32_t inner, std::size_t i);
+    void rebalance(std::uint32_t node, bool isLeaf);
+    void merge(std::uint32_t left, std::uint32_t right, bool isLeaf);
+    void shrinkRoot();
+};
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const BasicBTreeBeachline<T>& beachline)
+{
+    return beachline.print(os);
+}
+
+extern template class BasicBTreeBeachline<float>;
+extern template class BasicBTreeBeachline<double>;
+extern template class BasicBTreeBeachline<long double>;
+
+using BTreeBeachline = BasicBTreeBeachline<double>;
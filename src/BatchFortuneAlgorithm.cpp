@@ -0,0 +1,80 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BatchFortuneAlgorithm.h"
+// STL
+#include <algorithm>
+#include <stdexcept>
+
+BatchFortuneAlgorithm::BatchFortuneAlgorithm(std::size_t nbThreads) : mPool(nbThreads), mDuration(0)
+{
+    for (std::size_t i = 0; i < mPool.getNbThreads(); ++i)
+        mAlgorithms.emplace_back(new FortuneAlgorithm(std::vector<Vector2>()));
+}
+
+BatchFortuneAlgorithm::~BatchFortuneAlgorithm() = default;
+
+std::vector<VoronoiDiagram> BatchFortuneAlgorithm::construct(const std::vector<std::vector<Vector2>>& points,
+    const std::vector<Box>& boxes, std::vector<VoronoiDiagram> diagrams)
+{
+    if (points.size() != boxes.size())
+        throw std::invalid_argument("There must be one box per point set");
+    auto start = std::chrono::steady_clock::now();
+    if (diagrams.size() > points.size())
+        diagrams.erase(diagrams.begin() + points.size(), diagrams.end());
+    diagrams.reserve(points.size());
+    while (diagrams.size() < points.size())
+        diagrams.emplace_back(std::vector<Vector2>());
+    mValid.assign(points.size(), false);
+    mPool.run(points.size(), [&](std::size_t i, std::size_t thread)
+    {
+        FortuneAlgorithm& algorithm = *mAlgorithms[thread];
+        algorithm.reset(points[i], std::move(diagrams[i]));
+        algorithm.construct(FortuneAlgorithm::SiteEventMode::SORTED);
+        mValid[i] = algorithm.finalize(boxes[i]);
+        diagrams[i] = algorithm.getDiagram();
+    });
+    mDuration = std::chrono::steady_clock::now() - start;
+    return diagrams;
+}
+
+bool BatchFortuneAlgorithm::isValid(std::size_t i) const
+{
+    return mValid[i];
+}
+
+std::size_t BatchFortuneAlgorithm::getNbInvalidDiagrams() const
+{
+    return std::count(mValid.begin(), mValid.end(), false);
+}
+
+std::chrono::nanoseconds BatchFortuneAlgorithm::getDuration() const
+{
+    return mDuration;
+}
+
+double BatchFortuneAlgorithm::getThroughput() const
+{
+    if (mDuration.count() == 0)
+        return 0.0;
+    return mValid.size() / std::chrono::duration<double>(mDuration).count();
+}
+
+std::size_t BatchFortuneAlgorithm::getNbThreads() const
+{
+    return mPool.getNbThreads();
+}
@@ -0,0 +1,58 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <chrono>
+#include <memory>
+#include <vector>
+// My includes
+#include "VoronoiDiagram.h"
+#include "FortuneAlgorithm.h"
+#include "ThreadPool.h"
+
+// Construction of many independent diagrams on a thread pool
+// Each diagram is constructed, bounded and intersected with its box. Each worker
+// thread reuses the same FortuneAlgorithm for all the diagrams it constructs.
+class BatchFortuneAlgorithm
+{
+public:
+    // nbThreads = 0 means one thread per hardware core
+    explicit BatchFortuneAlgorithm(std::size_t nbThreads = 0);
+    ~BatchFortuneAlgorithm();
+
+    // The diagrams are returned in the same order as the point sets
+    // The memory of the diagrams returned by a previous batch can be reused
+    std::vector<VoronoiDiagram> construct(const std::vector<std::vector<Vector2>>& points, const std::vector<Box>& boxes,
+        std::vector<VoronoiDiagram> diagrams = {});
+
+    // Result of the intersection with the box of the last batch
+    bool isValid(std::size_t i) const;
+    std::size_t getNbInvalidDiagrams() const;
+
+    // Statistics of the last batch
+    std::chrono::nanoseconds getDuration() const;
+    double getThroughput() const; // Diagrams per second
+    std::size_t getNbThreads() const;
+
+private:
+    ThreadPool mPool;
+    std::vector<std::unique_ptr<FortuneAlgorithm>> mAlgorithms; // One per worker thread
+    std::vector<char> mValid;
+    std::chrono::nanoseconds mDuration;
+};
@@ -16,45 +16,69 @@
  */
 
 #include "Beachline.h"
-// STL
-#include <limits>
-#include <cmath>
 // My includes
 #include "Arc.h"
+#include "IntegerPredicates.h"
 
-Beachline::Beachline() : mNil(new Arc), mRoot(mNil)
+template<typename T>
+constexpr std::size_t BasicBeachline<T>::MAX_HINT_WALK;
+template<typename T>
+constexpr std::size_t BasicBeachline<T>::MAX_HINT_ASCENT;
+
+template<typename T>
+BasicBeachline<T>::BasicBeachline() : mNil(mArcPool.create()), mRoot(mNil), mIntegerSites(false)
 {
     mNil->color = Arc::Color::BLACK; 
 }
 
-Beachline::~Beachline()
+// The arcs are released in bulk with the slabs of the pool
+template<typename T>
+BasicBeachline<T>::~BasicBeachline() = default;
+
+template<typename T>
+void BasicBeachline<T>::reset()
 {
-    free(mRoot);    
-    delete mNil;
+    mArcPool.clear();
+    mNil = mArcPool.create();
+    mNil->color = Arc::Color::BLACK;
+    mRoot = mNil;
+    FORTUNE_STATISTICS_ONLY(mStatistics = Statistics{});
 }
 
-Arc* Beachline::createArc(VoronoiDiagram::Site* site)
+template<typename T>
+BasicArc<T>* BasicBeachline<T>::createArc(typename VoronoiDiagram::Site* site)
 {
-    return new Arc{mNil, mNil, mNil, site, nullptr, nullptr, nullptr, mNil, mNil, Arc::Color::RED};
+    return mArcPool.create(mNil, mNil, mNil, site, nullptr, nullptr, BasicEventQueue<T>::INVALID_HANDLE, mNil, mNil,
+        Arc::Color::RED, 0u);
 }
 
-bool Beachline::isEmpty() const
+template<typename T>
+void BasicBeachline<T>::deleteArc(Arc* arc)
+{
+    mArcPool.destroy(arc);
+}
+
+template<typename T>
+bool BasicBeachline<T>::isEmpty() const
 {
     return isNil(mRoot);
 }
 
-bool Beachline::isNil(const Arc* x) const
+template<typename T>
+bool BasicBeachline<T>::isNil(const Arc* x) const
 {
     return x == mNil;
 }
 
-void Beachline::setRoot(Arc* x)
+template<typename T>
+void BasicBeachline<T>::setRoot(Arc* x)
 {
     mRoot = x;
     mRoot->color = Arc::Color::BLACK;
 }
 
-Arc* Beachline::getLeftmostArc() const
+template<typename T>
+BasicArc<T>* BasicBeachline<T>::getLeftmostArc() const
 {
     Arc* x = mRoot;
     while (!isNil(x->prev))
@@ -62,29 +86,102 @@ Arc* Beachline::getLeftmostArc() const
     return x;
 }
 
-Arc* Beachline::locateArcAbove(const Vector2& point, double l) const
+template<typename T>
+void BasicBeachline<T>::setIntegerSites(bool integerSites)
+{
+    mIntegerSites = integerSites;
+}
+
+template<typename T>
+BasicArc<T>* BasicBeachline<T>::locateArcAbove(const Vector2& point, T l) const
+{
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocations);
+    Arc* arc = locateArcInSubtree(mRoot, mNil, mNil, point, l);
+    FORTUNE_STATISTICS_ONLY(mStatistics.nbRootLocationSteps += getDepth(arc) + 1);
+    return arc;
+}
+
+template<typename T>
+BasicArc<T>* BasicBeachline<T>::locateArcAbove(const Vector2& point, T l, Arc* hint) const
+{
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocations);
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbHintedLocations);
+    Arc* arc = locateArcFromHint(point, l, hint);
+    FORTUNE_STATISTICS_ONLY(mStatistics.nbRootLocationSteps += getDepth(arc) + 1);
+    return arc;
+}
+
+template<typename T>
+BasicArc<T>* BasicBeachline<T>::locateArcFromHint(const Vector2& point, T l, Arc* hint) const
 {
-    Arc* node = mRoot;
-    bool found = false;
-    while (!found)
+    // The point must be strictly inside the range of the arc or of the subtree where the search starts so that
+    // the result is the same as with a descent from the root when the point is on a breakpoint
+    // Walk along the beachline in the direction of the point
+    Arc* arc = hint;
+    int side = 0; // -1 if the point is on the left of the arc, 1 if it is on its right
+    for (std::size_t i = 0; ; ++i)
     {
-        double breakpointLeft = -std::numeric_limits<double>::infinity();
-        double breakpointRight = std::numeric_limits<double>::infinity();
-        if (!isNil(node->prev))
-           breakpointLeft =  computeBreakpoint(node->prev->site->point, node->site->point, l);
-        if (!isNil(node->next))
-            breakpointRight = computeBreakpoint(node->site->point, node->next->site->point, l);
-        if (point.x < breakpointLeft)
+        FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocationSteps);
+        // The breakpoint shared with the previous arc of the walk is already known
+        int left = side > 0 || isNil(arc->prev) ? 1 :
+            compareWithBreakpoint(arc->prev->site->point, arc->site->point, point.x, l, mIntegerSites);
+        int right = side < 0 || isNil(arc->next) ? -1 :
+            compareWithBreakpoint(arc->site->point, arc->next->site->point, point.x, l, mIntegerSites);
+        if (left > 0 && right < 0)
+            return arc;
+        side = left <= 0 ? -1 : 1;
+        if (i == MAX_HINT_WALK || left == 0 || right == 0)
+            break;
+        arc = side < 0 ? arc->prev : arc->next;
+    }
+    // Go up until the point is strictly inside the subtree, on the side of the walk it is already the case
+    // If the subtree is too high, the hint is far from the point and the search starts from the root
+    Arc* node = arc;
+    for (std::size_t i = 0; i < MAX_HINT_ASCENT && node != mRoot; ++i)
+    {
+        Arc* parent = node->parent;
+        FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocationSteps);
+        // The parent is the arc just before or just after the subtree
+        if (side < 0 && node == parent->right &&
+            compareWithBreakpoint(parent->site->point, parent->next->site->point, point.x, l, mIntegerSites) > 0)
+            return locateArcInSubtree(node, parent, mNil, point, l);
+        if (side > 0 && node == parent->left &&
+            compareWithBreakpoint(parent->prev->site->point, parent->site->point, point.x, l, mIntegerSites) < 0)
+            return locateArcInSubtree(node, mNil, parent, point, l);
+        node = parent;
+    }
+    return locateArcInSubtree(mRoot, mNil, mNil, point, l);
+}
+
+template<typename T>
+BasicArc<T>* BasicBeachline<T>::locateArcInSubtree(Arc* node, const Arc* leftBound, const Arc* rightBound,
+    const Vector2& point, T l) const
+{
+    // Last nodes whose right breakpoint is on the left of the point and whose left breakpoint is on its right
+    // These breakpoints are shared with their neighbors deeper in the tree so they are not compared twice
+    while (true)
+    {
+        FORTUNE_STATISTICS_ONLY(++mStatistics.nbLocationSteps);
+        // The missing breakpoints are at infinity
+        if (node->prev != leftBound &&
+            compareWithBreakpoint(node->prev->site->point, node->site->point, point.x, l, mIntegerSites) < 0)
+        {
+            rightBound = node;
             node = node->left;
-        else if (point.x > breakpointRight)
+        }
+        else if (node->next != rightBound &&
+            compareWithBreakpoint(node->site->point, node->next->site->point, point.x, l, mIntegerSites) > 0)
+        {
+            leftBound = node;
             node = node->right;
+        }
         else
-            found = true;
+            return node;
     }
-    return node;
 }
 
-void Beachline::insertBefore(Arc* x, Arc* y)
+template<typename T>
+void BasicBeachline<T>::insertBefore(Arc* x, Arc* y)
 {
     // Find the right place
     if (isNil(x->left))
@@ -107,7 +204,8 @@ void Beachline::insertBefore(Arc* x, Arc* y)
     insertFixup(y);    
 }
 
-void Beachline::insertAfter(Arc* x, Arc* y)
+template<typename T>
+void BasicBeachline<T>::insertAfter(Arc* x, Arc* y)
 {
     // Find the right place
     if (isNil(x->right))
@@ -130,7 +228,8 @@ void Beachline::insertAfter(Arc* x, Arc* y)
     insertFixup(y);    
 }
 
-void Beachline::replace(Arc* x, Arc* y)
+template<typename T>
+void BasicBeachline<T>::replace(Arc* x, Arc* y)
 {
     transplant(x, y);
     y->left = x->left;
@@ -148,10 +247,11 @@ void Beachline::replace(Arc* x, Arc* y)
     y->color = x->color;
 }
 
-void Beachline::remove(Arc* z)
+template<typename T>
+void BasicBeachline<T>::remove(Arc* z)
 {
     Arc* y = z;
-    Arc::Color yOriginalColor = y->color;
+    typename Arc::Color yOriginalColor = y->color;
     Arc* x;
     if (isNil(z->left))
     {
@@ -190,7 +290,8 @@ void Beachline::remove(Arc* z)
         z->next->prev = z->prev;
 }
 
-std::ostream& Beachline::print(std::ostream& os) const
+template<typename T>
+std::ostream& BasicBeachline<T>::print(std::ostream& os) const
 {
     //return printArc(os, mRoot);
     Arc* arc = getLeftmostArc();
@@ -202,14 +303,54 @@ std::ostream& Beachline::print(std::ostream& os) const
     return os;
 }
 
-Arc* Beachline::minimum(Arc* x) const
+template<typename T>
+std::size_t BasicBeachline<T>::getNbArcs() const
+{
+    return mArcPool.getNbElements() - 1; // Do not count Nil
+}
+
+template<typename T>
+std::size_t BasicBeachline<T>::getNbArcAllocations() const
+{
+    return mArcPool.getNbAllocations() - 1;
+}
+
+template<typename T>
+std::size_t BasicBeachline<T>::getNbArcSlabs() const
+{
+    return mArcPool.getNbSlabs();
+}
+
+#ifdef FORTUNE_STATISTICS
+template<typename T>
+const Statistics& BasicBeachline<T>::getStatistics() const
+{
+    return mStatistics;
+}
+#endif
+
+template<typename T>
+BasicArc<T>* BasicBeachline<T>::minimum(Arc* x) const
 {
     while (!isNil(x->left))
         x = x->left;
     return x;
 }
 
-void Beachline::transplant(Arc* u, Arc* v)
+template<typename T>
+std::size_t BasicBeachline<T>::getDepth(const Arc* x) const
+{
+    std::size_t depth = 0;
+    while (x != mRoot)
+    {
+        x = x->parent;
+        ++depth;
+    }
+    return depth;
+}
+
+template<typename T>
+void BasicBeachline<T>::transplant(Arc* u, Arc* v)
 {
     if (isNil(u->parent))
         mRoot = v;
@@ -220,7 +361,8 @@ void Beachline::transplant(Arc* u, Arc* v)
     v->parent = u->parent;
 }
 
-void Beachline::insertFixup(Arc* z)
+template<typename T>
+void BasicBeachline<T>::insertFixup(Arc* z)
 {
     while (z->parent->color == Arc::Color::RED)
     {
@@ -278,7 +420,8 @@ void Beachline::insertFixup(Arc* z)
     mRoot->color = Arc::Color::BLACK;
 }
 
-void Beachline::removeFixup(Arc* x)
+template<typename T>
+void BasicBeachline<T>::removeFixup(Arc* x)
 {
 
     while (x != mRoot && x->color == Arc::Color::BLACK)
@@ -358,8 +501,10 @@ void Beachline::removeFixup(Arc* x)
     x->color = Arc::Color::BLACK;
 }
 
-void Beachline::leftRotate(Arc* x)
+template<typename T>
+void BasicBeachline<T>::leftRotate(Arc* x)
 {
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbRotations);
     Arc* y = x->right;
     x->right = y->left;
     if (!isNil(y->left))
@@ -375,8 +520,10 @@ void Beachline::leftRotate(Arc* x)
     x->parent = y;
 }
 
-void Beachline::rightRotate(Arc* y)
+template<typename T>
+void BasicBeachline<T>::rightRotate(Arc* y)
 {
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbRotations);
     Arc* x = y->left;
     y->left = x->right;
     if (!isNil(x->right))
@@ -392,31 +539,8 @@ void Beachline::rightRotate(Arc* y)
     y->parent = x;
 }
 
-double Beachline::computeBreakpoint(const Vector2& point1, const Vector2& point2, double l) const
-{
-    double x1 = point1.x, y1 = point1.y, x2 = point2.x, y2 = point2.y;
-    double d1 = 1.0 / (2.0 * (y1 - l));
-	double d2 = 1.0 / (2.0 * (y2 - l));
-	double a = d1 - d2;
-	double b = 2.0 * (x2 * d2 - x1 * d1);
-	double c = (y1 * y1 + x1 * x1 - l * l) * d1 - (y2 * y2 + x2 * x2 - l * l) * d2;
-	double delta = b * b - 4.0 * a * c;
-    return (-b + std::sqrt(delta)) / (2.0 * a);
-}
-
-void Beachline::free(Arc* x)
-{
-    if (isNil(x))
-        return;
-    else
-    {
-        free(x->left);
-        free(x->right);
-        delete x;
-    }
-}
-
-std::ostream& Beachline::printArc(std::ostream& os, const Arc* arc, std::string tabs) const
+template<typename T>
+std::ostream& BasicBeachline<T>::printArc(std::ostream& os, const Arc* arc, std::string tabs) const
 {
     os << tabs << arc->site->index << ' ' << arc->leftHalfEdge << ' ' << arc->rightHalfEdge << std::endl;
     if (!isNil(arc->left))
@@ -426,7 +550,6 @@ std::ostream& Beachline::printArc(std::ostream& os, const Arc* arc, std::string
     return os;
 }
 
-std::ostream& operator<<(std::ostream& os, const Beachline& beachline)
-{
-    return beachline.print(os);
-}
+template class BasicBeachline<float>;
+template class BasicBeachline<double>;
+template class BasicBeachline<long double>;
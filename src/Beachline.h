@@ -20,29 +20,45 @@
 // My includes
 #include "Vector2.h"
 #include "VoronoiDiagram.h"
+#include "MemoryPool.h"
+#include "Arc.h"
+#include "Statistics.h"
 
-class Arc;
-
-class Beachline
+// T is the scalar type of the coordinates: float, double or long double
+template<typename T>
+class BasicBeachline
 {
 public:
-    Beachline();
-    ~Beachline();
+    using Scalar = T;
+    using Vector2 = BasicVector2<T>;
+    using VoronoiDiagram = BasicVoronoiDiagram<T>;
+    using Arc = BasicArc<T>;
+
+    BasicBeachline();
+    ~BasicBeachline();
 
     // Remove copy and move operations
-    Beachline(const Beachline&) = delete;
-    Beachline& operator=(const Beachline&) = delete;
-    Beachline(Beachline&&) = delete;
-    Beachline& operator=(Beachline&&) = delete;
+    BasicBeachline(const BasicBeachline&) = delete;
+    BasicBeachline& operator=(const BasicBeachline&) = delete;
+    BasicBeachline(BasicBeachline&&) = delete;
+    BasicBeachline& operator=(BasicBeachline&&) = delete;
+
+    // Remove all the arcs but keep the memory
+    void reset();
+
+    Arc* createArc(typename VoronoiDiagram::Site* site);
+    void deleteArc(Arc* arc);
 
-    Arc* createArc(VoronoiDiagram::Site* site);
-    
     bool isEmpty() const;
     bool isNil(const Arc* x) const;
     void setRoot(Arc* x);
     Arc* getLeftmostArc() const;
+    // Locate the arcs with the exact predicates of IntegerPredicates.h, the sites must have integer coordinates
+    void setIntegerSites(bool integerSites);
 
-    Arc* locateArcAbove(const Vector2& point, double l) const;
+    Arc* locateArcAbove(const Vector2& point, T l) const;
+    // Finger search starting from hint, faster if the point is close to it, the result is the same
+    Arc* locateArcAbove(const Vector2& point, T l, Arc* hint) const;
     void insertBefore(Arc* x, Arc* y);
     void insertAfter(Arc* x, Arc* y);
     void replace(Arc* x, Arc* y);
@@ -50,12 +66,38 @@ public:
 
     std::ostream& print(std::ostream& os) const;
 
+    // Memory
+    std::size_t getNbArcs() const;
+    std::size_t getNbArcAllocations() const;
+    std::size_t getNbArcSlabs() const;
+
+#ifdef FORTUNE_STATISTICS
+    // Statistics since the last reset, only the location counters and nbRotations are set
+    const Statistics& getStatistics() const;
+#endif
+
 private:
+    // Arcs visited along the beachline from the hint before going up the tree
+    static constexpr std::size_t MAX_HINT_WALK = 8;
+    // Levels climbed from the last arc of the walk before falling back to a descent from the root
+    static constexpr std::size_t MAX_HINT_ASCENT = 2;
+
+    MemoryPool<Arc> mArcPool;
     Arc* mNil;
     Arc* mRoot;
+    bool mIntegerSites;
+#ifdef FORTUNE_STATISTICS
+    mutable Statistics mStatistics;
+#endif
+
+    // Location
+    Arc* locateArcFromHint(const Vector2& point, T l, Arc* hint) const;
+    Arc* locateArcInSubtree(Arc* node, const Arc* leftBound, const Arc* rightBound, const Vector2& point,
+        T l) const;
 
     // Utility methods
     Arc* minimum(Arc* x) const;
+    std::size_t getDepth(const Arc* x) const;
     void transplant(Arc* u, Arc* v); 
 
     // Fixup functions
@@ -66,11 +108,17 @@ private:
     void leftRotate(Arc* x);
     void rightRotate(Arc* y);
 
-    double computeBreakpoint(const Vector2& point1, const Vector2& point2, double l) const;
-
-    void free(Arc* x);
-
     std::ostream& printArc(std::ostream& os, const Arc* arc, std::string tabs = "") const;
 };
 
-std::ostream& operator<<(std::ostream& os, const Beachline& beachline);
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const BasicBeachline<T>& beachline)
+{
+    return beachline.print(os);
+}
+
+extern template class BasicBeachline<float>;
+extern template class BasicBeachline<double>;
+extern template class BasicBeachline<long double>;
+
+using Beachline = BasicBeachline<double>;
@@ -16,107 +16,512 @@
  */
 
 #include "Box.h"
+// STL
+#include <algorithm>
+#include <cmath>
+// SIMD
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-bool Box::contains(const Vector2& point) const
+namespace
 {
-    return point.x >= left - EPSILON && point.x <= right + EPSILON &&
-        point.y >= bottom  - EPSILON && point.y <= top + EPSILON;
+
+// Packs of scalars with the same interface for the scalar version and each instruction set
+// The kernels only use additions, multiplications, divisions and comparisons so all the packs give the same results
+
+template<typename S>
+struct ScalarPack
+{
+    static constexpr std::size_t SIZE = 1;
+    using Scalar = S;
+    using Type = S;
+    using Mask = bool;
+
+    static Type load(const S* x) { return *x; }
+    static void store(S* x, Type a) { *x = a; }
+    static Type set(S x) { return x; }
+    static Type add(Type a, Type b) { return a + b; }
+    static Type sub(Type a, Type b) { return a - b; }
+    static Type mul(Type a, Type b) { return a * b; }
+    static Type div(Type a, Type b) { return a / b; }
+    static Mask less(Type a, Type b) { return a < b; }
+    static Mask lessEqual(Type a, Type b) { return a <= b; }
+    static Mask equal(Type a, Type b) { return a == b; }
+    static Mask both(Mask a, Mask b) { return a && b; }
+    static Mask either(Mask a, Mask b) { return a || b; }
+    static Type select(Mask mask, Type a, Type b) { return mask ? a : b; }
+    static int getBits(Mask mask) { return mask ? 1 : 0; }
+};
+
+// Widest pack of each scalar type, long double is never vectorized
+template<typename S>
+struct WidePackOf
+{
+    using Type = ScalarPack<S>;
+};
+
+#if defined(__AVX__)
+
+struct AvxPack
+{
+    static constexpr std::size_t SIZE = 4;
+    using Scalar = double;
+    using Type = __m256d;
+    using Mask = __m256d;
+
+    static Type load(const double* x) { return _mm256_loadu_pd(x); }
+    static void store(double* x, Type a) { _mm256_storeu_pd(x, a); }
+    static Type set(double x) { return _mm256_set1_pd(x); }
+    static Type add(Type a, Type b) { return _mm256_add_pd(a, b); }
+    static Type sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+    static Type mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+    static Type div(Type a, Type b) { return _mm256_div_pd(a, b); }
+    static Mask less(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static Mask lessEqual(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static Mask equal(Type a, Type b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static Mask both(Mask a, Mask b) { return _mm256_and_pd(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+    static Type select(Mask mask, Type a, Type b) { return _mm256_blendv_pd(b, a, mask); }
+    static int getBits(Mask mask) { return _mm256_movemask_pd(mask); }
+};
+
+struct AvxFloatPack
+{
+    static constexpr std::size_t SIZE = 8;
+    using Scalar = float;
+    using Type = __m256;
+    using Mask = __m256;
+
+    static Type load(const float* x) { return _mm256_loadu_ps(x); }
+    static void store(float* x, Type a) { _mm256_storeu_ps(x, a); }
+    static Type set(float x) { return _mm256_set1_ps(x); }
+    static Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static Type div(Type a, Type b) { return _mm256_div_ps(a, b); }
+    static Mask less(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Mask lessEqual(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static Mask equal(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static Mask both(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+    static Type select(Mask mask, Type a, Type b) { return _mm256_blendv_ps(b, a, mask); }
+    static int getBits(Mask mask) { return _mm256_movemask_ps(mask); }
+};
+
+template<>
+struct WidePackOf<double>
+{
+    using Type = AvxPack;
+};
+
+template<>
+struct WidePackOf<float>
+{
+    using Type = AvxFloatPack;
+};
+
+#elif defined(__SSE2__)
+
+struct Sse2Pack
+{
+    static constexpr std::size_t SIZE = 2;
+    using Scalar = double;
+    using Type = __m128d;
+    using Mask = __m128d;
+
+    static Type load(const double* x) { return _mm_loadu_pd(x); }
+    static void store(double* x, Type a) { _mm_storeu_pd(x, a); }
+    static Type set(double x) { return _mm_set1_pd(x); }
+    static Type add(Type a, Type b) { return _mm_add_pd(a, b); }
+    static Type sub(Type a, Type b) { return _mm_sub_pd(a, b); }
+    static Type mul(Type a, Type b) { return _mm_mul_pd(a, b); }
+    static Type div(Type a, Type b) { return _mm_div_pd(a, b); }
+    static Mask less(Type a, Type b) { return _mm_cmplt_pd(a, b); }
+    static Mask lessEqual(Type a, Type b) { return _mm_cmple_pd(a, b); }
+    static Mask equal(Type a, Type b) { return _mm_cmpeq_pd(a, b); }
+    static Mask both(Mask a, Mask b) { return _mm_and_pd(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm_or_pd(a, b); }
+    static Type select(Mask mask, Type a, Type b) { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+    static int getBits(Mask mask) { return _mm_movemask_pd(mask); }
+};
+
+struct SseFloatPack
+{
+    static constexpr std::size_t SIZE = 4;
+    using Scalar = float;
+    using Type = __m128;
+    using Mask = __m128;
+
+    static Type load(const float* x) { return _mm_loadu_ps(x); }
+    static void store(float* x, Type a) { _mm_storeu_ps(x, a); }
+    static Type set(float x) { return _mm_set1_ps(x); }
+    static Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+    static Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+    static Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+    static Type div(Type a, Type b) { return _mm_div_ps(a, b); }
+    static Mask less(Type a, Type b) { return _mm_cmplt_ps(a, b); }
+    static Mask lessEqual(Type a, Type b) { return _mm_cmple_ps(a, b); }
+    static Mask equal(Type a, Type b) { return _mm_cmpeq_ps(a, b); }
+    static Mask both(Mask a, Mask b) { return _mm_and_ps(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm_or_ps(a, b); }
+    static Type select(Mask mask, Type a, Type b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    static int getBits(Mask mask) { return _mm_movemask_ps(mask); }
+};
+
+template<>
+struct WidePackOf<double>
+{
+    using Type = Sse2Pack;
+};
+
+template<>
+struct WidePackOf<float>
+{
+    using Type = SseFloatPack;
+};
+
+#endif
+
+template<typename S>
+using WidePack = typename WidePackOf<S>::Type;
+
+// Call f(pack, i) on the first element i of each pack, the remaining elements are processed one by one
+template<typename S, typename F>
+void forEachPack(std::size_t n, F f)
+{
+    std::size_t i = 0;
+    for (; i + WidePack<S>::SIZE <= n; i += WidePack<S>::SIZE)
+        f(WidePack<S>(), i);
+    for (; i < n; ++i)
+        f(ScalarPack<S>(), i);
 }
 
-Box::Intersection Box::getFirstIntersection(const Vector2& origin, const Vector2& direction) const
+template<typename P, typename S = typename P::Scalar>
+void getFirstIntersectionsKernel(const BasicBox<S>& box, std::size_t i, const S* originX, const S* originY,
+    const S* directionX, const S* directionY, typename BasicBox<S>::Intersection* intersections)
 {
-    // origin must be in the box
-    Intersection intersection;
-    double t = std::numeric_limits<double>::infinity();
-    if (direction.x > 0.0)
+    using Side = typename BasicBox<S>::Side;
+    using Intersection = typename BasicBox<S>::Intersection;
+    using T = typename P::Type;
+    T ox = P::load(originX + i);
+    T oy = P::load(originY + i);
+    T dx = P::load(directionX + i);
+    T dy = P::load(directionY + i);
+    T zero = P::set(S(0));
+    T infinity = P::set(std::numeric_limits<S>::infinity());
+    // Vertical sides
+    auto positiveX = P::less(zero, dx);
+    T t = P::select(positiveX, P::div(P::sub(P::set(box.right), ox), dx),
+        P::select(P::less(dx, zero), P::div(P::sub(P::set(box.left), ox), dx), infinity));
+    T side = P::select(positiveX, P::set(static_cast<S>(Side::RIGHT)), P::set(static_cast<S>(Side::LEFT)));
+    // Horizontal sides, only if they are strictly closer
+    auto positiveY = P::less(zero, dy);
+    T newT = P::select(positiveY, P::div(P::sub(P::set(box.top), oy), dy),
+        P::select(P::less(dy, zero), P::div(P::sub(P::set(box.bottom), oy), dy), infinity));
+    auto closer = P::less(newT, t);
+    t = P::select(closer, newT, t);
+    side = P::select(closer, P::select(positiveY, P::set(static_cast<S>(Side::TOP)),
+        P::set(static_cast<S>(Side::BOTTOM))), side);
+    // Write the intersections
+    S xs[P::SIZE], ys[P::SIZE], sides[P::SIZE];
+    P::store(xs, P::add(ox, P::mul(t, dx)));
+    P::store(ys, P::add(oy, P::mul(t, dy)));
+    P::store(sides, side);
+    for (std::size_t j = 0; j < P::SIZE; ++j)
+        intersections[i + j] = Intersection{static_cast<Side>(static_cast<int>(sides[j])),
+            BasicVector2<S>(xs[j], ys[j])};
+}
+
+template<typename P, typename S = typename P::Scalar>
+void getIntersectionsKernel(const BasicBox<S>& box, S epsilon, std::size_t i, const S* originX, const S* originY,
+    const S* destinationX, const S* destinationY, int* nbIntersections,
+    std::array<typename BasicBox<S>::Intersection, 2>* intersections)
+{
+    using Side = typename BasicBox<S>::Side;
+    using Intersection = typename BasicBox<S>::Intersection;
+    using T = typename P::Type;
+    T ox = P::load(originX + i);
+    T oy = P::load(originY + i);
+    T ex = P::load(destinationX + i);
+    T ey = P::load(destinationY + i);
+    T dx = P::sub(ex, ox);
+    T dy = P::sub(ey, oy);
+    // The ends on a side of the box give intersections too
+    T minT = P::set(-epsilon);
+    T maxT = P::set(S(1) + epsilon);
+    // Candidate intersection with each side, indexed by side
+    S ts[4][P::SIZE], xs[4][P::SIZE], ys[4][P::SIZE];
+    int accepted[4];
+    T zero = P::set(S(0));
+    auto abs = [&](T a)
     {
-        t = (right - origin.x) / direction.x;
-        intersection.side = Side::RIGHT;
-        intersection.point = origin + t * direction;
-    }
-    else if (direction.x < 0.0)
+        return P::select(P::less(a, zero), P::sub(zero, a), a);
+    };
+    // The error on the other coordinate grows with the magnitude of the ends, it is bounded relative to them
+    T scale = P::set(std::max({std::abs(box.left), std::abs(box.bottom), std::abs(box.right), std::abs(box.top), S(1)}));
+    T toleranceX = P::mul(P::set(4 * epsilon), P::add(scale, P::add(abs(ox), abs(ex))));
+    T toleranceY = P::mul(P::set(4 * epsilon), P::add(scale, P::add(abs(oy), abs(ey))));
+    auto intersectSide = [&](Side side, T o, T e, T d, S value, bool lower, T otherO, T otherD, S otherMin,
+        S otherMax, T otherTolerance, bool vertical)
     {
-        t = (left - origin.x) / direction.x;
-        intersection.side = Side::LEFT;
-        intersection.point = origin + t * direction;
-    }
-    if (direction.y > 0.0)
+        // One of the ends must be beyond the side
+        T threshold = lower ? P::set(value - epsilon) : P::set(value + epsilon);
+        auto beyond = lower ? P::either(P::less(o, threshold), P::less(e, threshold)) :
+            P::either(P::less(threshold, o), P::less(threshold, e));
+        T t = P::div(P::sub(P::set(value), o), d);
+        T other = P::add(otherO, P::mul(t, otherD));
+        T low = P::set(otherMin);
+        T high = P::set(otherMax);
+        auto mask = P::both(P::both(beyond, P::both(P::less(minT, t), P::less(t, maxT))),
+            P::both(P::lessEqual(P::sub(low, otherTolerance), other), P::lessEqual(other, P::add(high, otherTolerance))));
+        // The intersection is put exactly on the side and in the box, a corner is then found exactly
+        other = P::select(P::less(other, low), low, P::select(P::less(high, other), high, other));
+        int s = static_cast<int>(side);
+        P::store(ts[s], t);
+        P::store(xs[s], vertical ? P::set(value) : other);
+        P::store(ys[s], vertical ? other : P::set(value));
+        accepted[s] = P::getBits(mask);
+    };
+    intersectSide(Side::LEFT, ox, ex, dx, box.left, true, oy, dy, box.bottom, box.top, toleranceY, true);
+    intersectSide(Side::RIGHT, ox, ex, dx, box.right, false, oy, dy, box.bottom, box.top, toleranceY, true);
+    intersectSide(Side::BOTTOM, oy, ey, dy, box.bottom, true, ox, dx, box.left, box.right, toleranceX, false);
+    intersectSide(Side::TOP, oy, ey, dy, box.top, false, ox, dx, box.left, box.right, toleranceX, false);
+    // Keep the nearest and the farthest intersections
+    for (std::size_t j = 0; j < P::SIZE; ++j)
     {
-        double newT = (top - origin.y) / direction.y;
-        if (newT < t)
+        std::array<Intersection, 2>& laneIntersections = intersections[i + j];
+        int first = -1;
+        int last = -1;
+        for (int s = 0; s < 4; ++s)
         {
-            intersection.side = Side::TOP;
-            intersection.point = origin + newT * direction;
+            if (accepted[s] >> j & 1)
+            {
+                if (first == -1 || ts[s][j] < ts[first][j])
+                    first = s;
+                if (last == -1 || ts[s][j] > ts[last][j])
+                    last = s;
+            }
         }
-    }
-    else if (direction.y < 0.0)
-    {
-        double newT = (bottom - origin.y) / direction.y;
-        if (newT < t)
+        auto getIntersection = [&](int s)
         {
-            intersection.side = Side::BOTTOM;
-            intersection.point = origin + newT * direction;
+            return Intersection{static_cast<Side>(s), BasicVector2<S>(xs[s][j], ys[s][j])};
+        };
+        bool originInside = box.contains(BasicVector2<S>(originX[i + j], originY[i + j]));
+        bool destinationInside = box.contains(BasicVector2<S>(destinationX[i + j], destinationY[i + j]));
+        int k = 0;
+        // A segment with an end inside crosses the box once, at the intersection the farthest from this end
+        if (first != -1 && originInside != destinationInside)
+        {
+            laneIntersections[0] = getIntersection(originInside ? last : first);
+            k = 1;
+        }
+        // A segment only touching the box, at a corner for instance, is outside
+        else if (first != -1 && !originInside && ts[last][j] - ts[first][j] > epsilon)
+        {
+            laneIntersections[0] = getIntersection(first);
+            laneIntersections[1] = getIntersection(last);
+            k = 2;
         }
+        nbIntersections[i + j] = k;
     }
-    return intersection;
 }
 
-int Box::getIntersections(const Vector2& origin, const Vector2& destination, std::array<Intersection, 2>& intersections) const
-{
-    // WARNING: If the intersection is a corner, both intersections are equals
-    Vector2 direction = destination - origin;
-    std::array<double, 2> t;
-    std::size_t i = 0; // index of the current intersection
-    // Left
-    if (origin.x < left - EPSILON || destination.x < left - EPSILON)
-    {   
-        t[i] = (left - origin.x) / direction.x;
-        if (t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
-        {
-            intersections[i].side = Side::LEFT;
-            intersections[i].point = origin + t[i] * direction;
-            if (intersections[i].point.y >= bottom  - EPSILON && intersections[i].point.y <= top + EPSILON)
-                ++i;
-        }
+template<typename P, typename S = typename P::Scalar>
+void clipKernel(const BasicBox<S>& box, std::size_t i, const S* originX, const S* originY, const S* directionX,
+    const S* directionY, S* t0, typename BasicBox<S>::Side* sides0, S* t1, typename BasicBox<S>::Side* sides1,
+    char* valid)
+{
+    using Side = typename BasicBox<S>::Side;
+    using T = typename P::Type;
+    using M = typename P::Mask;
+    T ox = P::load(originX + i);
+    T oy = P::load(originY + i);
+    T dx = P::load(directionX + i);
+    T dy = P::load(directionY + i);
+    T start = P::load(t0 + i);
+    T end = P::load(t1 + i);
+    S sideValues[2][P::SIZE];
+    for (std::size_t j = 0; j < P::SIZE; ++j)
+    {
+        sideValues[0][j] = static_cast<S>(sides0[i + j]);
+        sideValues[1][j] = static_cast<S>(sides1[i + j]);
     }
-    // Right
-    if (origin.x > right + EPSILON || destination.x > right + EPSILON)
-    {   
-        t[i] = (right - origin.x) / direction.x;
-        if (t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
-        {
-            intersections[i].side = Side::RIGHT;
-            intersections[i].point = origin + t[i] * direction;
-            if (intersections[i].point.y >= bottom - EPSILON && intersections[i].point.y <= top + EPSILON)
-                ++i;
-        }
+    T startSide = P::load(sideValues[0]);
+    T endSide = P::load(sideValues[1]);
+    T zero = P::set(S(0));
+    M inside = P::equal(zero, zero);
+    // Liang-Barsky algorithm, each side gives a constraint p * t <= q
+    auto clipSide = [&](T p, T q, Side side)
+    {
+        // A line parallel to the side is either always or never on the right side
+        inside = P::both(inside, P::either(P::less(p, zero), P::either(P::less(zero, p), P::lessEqual(zero, q))));
+        T t = P::div(q, p);
+        T sideValue = P::set(static_cast<S>(side));
+        // The line enters the half-plane through the side
+        M enters = P::both(P::less(p, zero), P::less(start, t));
+        start = P::select(enters, t, start);
+        startSide = P::select(enters, sideValue, startSide);
+        // The line leaves the half-plane through the side
+        M leaves = P::both(P::less(zero, p), P::less(t, end));
+        end = P::select(leaves, t, end);
+        endSide = P::select(leaves, sideValue, endSide);
+    };
+    clipSide(P::sub(zero, dx), P::sub(ox, P::set(box.left)), Side::LEFT);
+    clipSide(dx, P::sub(P::set(box.right), ox), Side::RIGHT);
+    clipSide(P::sub(zero, dy), P::sub(oy, P::set(box.bottom)), Side::BOTTOM);
+    clipSide(dy, P::sub(P::set(box.top), oy), Side::TOP);
+    int bits = P::getBits(P::both(inside, P::less(start, end)));
+    P::store(t0 + i, start);
+    P::store(t1 + i, end);
+    P::store(sideValues[0], startSide);
+    P::store(sideValues[1], endSide);
+    for (std::size_t j = 0; j < P::SIZE; ++j)
+    {
+        sides0[i + j] = static_cast<Side>(static_cast<int>(sideValues[0][j]));
+        sides1[i + j] = static_cast<Side>(static_cast<int>(sideValues[1][j]));
+        valid[i + j] = bits >> j & 1;
     }
-    // Bottom
-    if (origin.y < bottom - EPSILON || destination.y < bottom - EPSILON)
-    {   
-        t[i] = (bottom - origin.y) / direction.y;
-        if (i < 2 && t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
+}
+
+}
+
+template<typename T>
+constexpr T BasicBox<T>::EPSILON;
+
+template<typename T>
+bool BasicBox<T>::contains(const Vector2& point) const
+{
+    return point.x >= left - EPSILON && point.x <= right + EPSILON &&
+        point.y >= bottom  - EPSILON && point.y <= top + EPSILON;
+}
+
+template<typename T>
+typename BasicBox<T>::Side BasicBox<T>::getBorderSide(const Vector2& point, Side side, bool isEnd) const
+{
+    // Check if the point is on a corner, up to rounding errors
+    T tolerance = 4 * EPSILON * std::max({std::abs(left), std::abs(bottom), std::abs(right), std::abs(top), T(1)});
+    bool onLeft = std::abs(point.x - left) <= tolerance;
+    bool onRight = std::abs(point.x - right) <= tolerance;
+    bool onBottom = std::abs(point.y - bottom) <= tolerance;
+    bool onTop = std::abs(point.y - top) <= tolerance;
+    if (!(onLeft || onRight) || !(onBottom || onTop))
+        return side;
+    // The corner is at the start of the side after it in counterclockwise order
+    int verticalSide = static_cast<int>(onLeft ? Side::LEFT : Side::RIGHT);
+    int horizontalSide = static_cast<int>(onBottom ? Side::BOTTOM : Side::TOP);
+    bool isVerticalBefore = (verticalSide + 1) % 4 == horizontalSide;
+    return static_cast<Side>(isVerticalBefore == isEnd ? verticalSide : horizontalSide);
+}
+
+template<typename T>
+typename BasicBox<T>::Intersection BasicBox<T>::getFirstIntersection(const Vector2& origin,
+    const Vector2& direction) const
+{
+    // origin must be in the box
+    Intersection intersection;
+    getFirstIntersectionsKernel<ScalarPack<T>>(*this, 0, &origin.x, &origin.y, &direction.x, &direction.y, &intersection);
+    return intersection;
+}
+
+template<typename T>
+int BasicBox<T>::getIntersections(const Vector2& origin, const Vector2& destination,
+    std::array<Intersection, 2>& intersections) const
+{
+    int nbIntersections;
+    getIntersectionsKernel<ScalarPack<T>>(*this, EPSILON, 0, &origin.x, &origin.y, &destination.x, &destination.y,
+        &nbIntersections, &intersections);
+    return nbIntersections;
+}
+
+template<typename T>
+bool BasicBox<T>::clip(const Vector2& origin, const Vector2& direction, T& t0, Side& side0, T& t1, Side& side1) const
+{
+    char valid;
+    clipKernel<ScalarPack<T>>(*this, 0, &origin.x, &origin.y, &direction.x, &direction.y, &t0, &side0, &t1, &side1, &valid);
+    return valid;
+}
+
+template<typename T>
+void BasicBox<T>::clipPolygon(std::vector<Vector2>& vertices, std::vector<Vector2>& buffer) const
+{
+    // Clip by the sides one after the other, the distances to the sides are positive inside
+    const std::array<T, 4> bounds = {left, bottom, right, top};
+    for (std::size_t side = 0; side < 4 && !vertices.empty(); ++side)
+    {
+        bool vertical = side % 2 == 0;
+        T sign = side < 2 ? T(1) : T(-1);
+        auto getDistance = [&](const Vector2& point)
         {
-            intersections[i].side = Side::BOTTOM;
-            intersections[i].point = origin + t[i] * direction;
-            if (intersections[i].point.x >= left  - EPSILON && intersections[i].point.x <= right + EPSILON)
-                ++i;
-        }
-    }
-    // Top
-    if (origin.y > top + EPSILON || destination.y > top + EPSILON)
-    {   
-        t[i] = (top - origin.y) / direction.y;
-        if (i < 2 && t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
+            return sign * ((vertical ? point.x : point.y) - bounds[side]);
+        };
+        buffer.clear();
+        Vector2 prevVertex = vertices.back();
+        T prevDistance = getDistance(prevVertex);
+        for (const Vector2& vertex : vertices)
         {
-            intersections[i].side = Side::TOP;
-            intersections[i].point = origin + t[i] * direction;
-            if (intersections[i].point.x >= left - EPSILON && intersections[i].point.x <= right + EPSILON)
-                ++i;
+            T distance = getDistance(vertex);
+            if ((prevDistance >= T(0)) != (distance >= T(0)))
+            {
+                // The intersection is put exactly on the side
+                Vector2 intersection = prevVertex + (prevDistance / (prevDistance - distance)) * (vertex - prevVertex);
+                (vertical ? intersection.x : intersection.y) = bounds[side];
+                buffer.push_back(intersection);
+            }
+            if (distance >= T(0))
+                buffer.push_back(vertex);
+            prevVertex = vertex;
+            prevDistance = distance;
         }
+        std::swap(vertices, buffer);
     }
-    // Sort the intersections from the nearest to the farthest
-    if (i == 2 && t[0] > t[1])
-        std::swap(intersections[0], intersections[1]);
-    return i;
 }
+
+template<typename T>
+void BasicBox<T>::getFirstIntersections(const Vector2Array& origins, const Vector2Array& directions,
+    std::vector<Intersection>& intersections) const
+{
+    std::size_t n = origins.getSize();
+    intersections.resize(n);
+    forEachPack<T>(n, [&](auto pack, std::size_t i)
+    {
+        getFirstIntersectionsKernel<decltype(pack)>(*this, i, origins.x.data(), origins.y.data(), directions.x.data(),
+            directions.y.data(), intersections.data());
+    });
+}
+
+template<typename T>
+void BasicBox<T>::getIntersections(const Vector2Array& origins, const Vector2Array& destinations,
+    std::vector<int>& nbIntersections,
+    std::vector<std::array<Intersection, 2>>& intersections) const
+{
+    std::size_t n = origins.getSize();
+    nbIntersections.resize(n);
+    intersections.resize(n);
+    forEachPack<T>(n, [&](auto pack, std::size_t i)
+    {
+        getIntersectionsKernel<decltype(pack)>(*this, EPSILON, i, origins.x.data(), origins.y.data(), destinations.x.data(),
+            destinations.y.data(), nbIntersections.data(), intersections.data());
+    });
+}
+
+template<typename T>
+void BasicBox<T>::clip(const Vector2Array& origins, const Vector2Array& directions, std::vector<T>& t0,
+    std::vector<Side>& sides0, std::vector<T>& t1, std::vector<Side>& sides1, std::vector<char>& valid) const
+{
+    std::size_t n = origins.getSize();
+    sides0.resize(n, Side::LEFT);
+    sides1.resize(n, Side::LEFT);
+    valid.resize(n);
+    forEachPack<T>(n, [&](auto pack, std::size_t i)
+    {
+        clipKernel<decltype(pack)>(*this, i, origins.x.data(), origins.y.data(), directions.x.data(), directions.y.data(),
+            t0.data(), sides0.data(), t1.data(), sides1.data(), valid.data());
+    });
+}
+
+template class BasicBox<float>;
+template class BasicBox<double>;
+template class BasicBox<long double>;
@@ -20,12 +20,19 @@
 // STL
 #include <array>
 #include <limits>
+#include <vector>
 // My includes
 #include "Vector2.h"
 
-class Box
+// T is the scalar type of the coordinates: float, double or long double
+template<typename T>
+class BasicBox
 {
 public:
+    using Scalar = T;
+    using Vector2 = BasicVector2<T>;
+    using Vector2Array = BasicVector2Array<T>;
+
     // Be careful, y-axis is oriented to the top like in math
     enum class Side : int {LEFT, BOTTOM, RIGHT, TOP};
 
@@ -35,16 +42,40 @@ public:
         Vector2 point;
     };
 
-    double left;
-    double bottom;
-    double right;
-    double top;
+    T left;
+    T bottom;
+    T right;
+    T top;
 
     bool contains(const Vector2& point) const;
     Intersection getFirstIntersection(const Vector2& origin, const Vector2& direction) const; // Useful for Fortune's algorithm
+    // A segment with an end inside the box has at most one intersection, a segment only touching the box has none
     int getIntersections(const Vector2& origin, const Vector2& destination, std::array<Intersection, 2>& intersections) const; // Useful for diagram intersection
+    // Clip the part origin + t * direction of a line with t in [t0, t1], the bounds can be infinite
+    // The sides are only set if the corresponding bounds are clipped
+    bool clip(const Vector2& origin, const Vector2& direction, T& t0, Side& side0, T& t1, Side& side1) const; // Useful for diagram finalization
+    // Clip a convex polygon in place with the Sutherland-Hodgman algorithm, buffer is only used to avoid allocations
+    void clipPolygon(std::vector<Vector2>& vertices, std::vector<Vector2>& buffer) const; // Useful for streaming
+    // Side of a point of the boundary for a walk along the box in counterclockwise order, a corner belongs to the side
+    // before it if the walk ends at the point and to the side after it otherwise
+    Side getBorderSide(const Vector2& point, Side side, bool isEnd) const;
+
+    // Batched versions, they give the same results as the functions above
+    // They are vectorized with AVX or SSE2 when the compiler targets them, except for long double
+    void getFirstIntersections(const Vector2Array& origins, const Vector2Array& directions,
+        std::vector<Intersection>& intersections) const;
+    void getIntersections(const Vector2Array& origins, const Vector2Array& destinations, std::vector<int>& nbIntersections,
+        std::vector<std::array<Intersection, 2>>& intersections) const;
+    // t0 and t1 are read and written, valid[i] is false if the line i does not cross the box
+    void clip(const Vector2Array& origins, const Vector2Array& directions, std::vector<T>& t0, std::vector<Side>& sides0,
+        std::vector<T>& t1, std::vector<Side>& sides1, std::vector<char>& valid) const;
 
 private:
-    static constexpr double EPSILON = std::numeric_limits<double>::epsilon();
+    static constexpr T EPSILON = std::numeric_limits<T>::epsilon();
 };
 
+extern template class BasicBox<float>;
+extern template class BasicBox<double>;
+extern template class BasicBox<long double>;
+
+using Box = BasicBox<double>;
@@ -0,0 +1,60 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// My includes
+#include "Vector2.h"
+
+// Position of x relative to the breakpoint between the arcs of (x1, y1) on the left and (x2, y2) on the right
+// Returns -1 if x is on the left, 1 if it is on the right and 0 if it is on the breakpoint
+// The breakpoint is not computed: the coordinates are translated so that the point is (0, 0) with l = 0,
+// and the quadratic equation is multiplied by 2 * (y1 - l) * (y2 - l) > 0 to remove the divisions,
+// then the root (-b + sqrt(delta)) / (2a) is compared with 0 using the signs of b and b * b - delta
+template<typename T>
+int compareWithBreakpoint(T x1, T y1, T x2, T y2, T x, T l)
+{
+    // Degenerate cases: the bisector is vertical or one of the parabolas is a vertical ray
+    T breakpoint;
+    if (y1 == y2)
+        breakpoint = T(0.5) * (x1 + x2);
+    else if (y1 == l)
+        breakpoint = x1;
+    else if (y2 == l)
+        breakpoint = x2;
+    else
+    {
+        T u1 = x1 - x;
+        T u2 = x2 - x;
+        T e1 = y1 - l;
+        T e2 = y2 - l;
+        T a = e2 - e1;
+        T b = T(2) * (u2 * e1 - u1 * e2);
+        T c = (e1 * e1 + u1 * u1) * e2 - (e2 * e2 + u2 * u2) * e1;
+        T delta = b * b - T(4) * a * c;
+        // Sign of b - sqrt(delta), it is the opposite of the sign of the root if a > 0
+        int sign = b < T(0) ? -1 : (b * b < delta ? -1 : (b * b > delta ? 1 : 0));
+        return a > T(0) ? sign : -sign;
+    }
+    return x < breakpoint ? -1 : (x > breakpoint ? 1 : 0);
+}
+
+template<typename T>
+int compareWithBreakpoint(const BasicVector2<T>& point1, const BasicVector2<T>& point2, T x, T l)
+{
+    return compareWithBreakpoint(point1.x, point1.y, point2.x, point2.y, x, l);
+}
@@ -0,0 +1,458 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagramCodec.h"
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Index = FrozenDiagram::Index;
+
+constexpr char MAGIC[8] = {'V', 'O', 'R', 'O', 'N', 'O', 'I', 'Z'};
+// Increment when the encoding changes
+constexpr std::uint64_t ENCODING_VERSION = 1;
+constexpr int MAX_NB_BITS = 32;
+// Used to reserve the half edges before decoding the faces
+constexpr std::size_t AVERAGE_NB_HALF_EDGES_PER_FACE = 6;
+
+std::uint64_t encodeZigZag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t decodeZigZag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// Quantization of a coordinate in [min, max] on nbBits bits
+class Quantizer
+{
+public:
+    Quantizer(double min, double max, int nbBits) : mMin(min), mMaxValue((std::uint64_t(1) << nbBits) - 1),
+        mScale(static_cast<double>(mMaxValue) / (max - min))
+    {
+
+    }
+
+    std::int64_t quantize(double x) const
+    {
+        double value = std::round((x - mMin) * mScale);
+        return static_cast<std::int64_t>(std::min(std::max(value, 0.0), static_cast<double>(mMaxValue)));
+    }
+
+    double dequantize(std::int64_t value) const
+    {
+        return mMin + static_cast<double>(value) / mScale;
+    }
+
+private:
+    double mMin;
+    std::uint64_t mMaxValue;
+    double mScale;
+};
+
+// The bytes are gathered in a small buffer to reduce the calls to the stream buffer
+class Writer
+{
+public:
+    explicit Writer(std::ostream& stream) : mBuffer(stream.rdbuf())
+    {
+
+    }
+
+    void writeBytes(const char* bytes, std::size_t nbBytes)
+    {
+        if (mSize + nbBytes > BUFFER_SIZE)
+            flush();
+        std::memcpy(mBytes + mSize, bytes, nbBytes);
+        mSize += nbBytes;
+        mNbBytes += nbBytes;
+    }
+
+    void writeVarint(std::uint64_t value)
+    {
+        char bytes[10];
+        std::size_t nbBytes = 0;
+        while (value >= 0x80)
+        {
+            bytes[nbBytes++] = static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        bytes[nbBytes++] = static_cast<char>(value);
+        writeBytes(bytes, nbBytes);
+    }
+
+    // Little endian bit pattern
+    void writeDouble(double x)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(double));
+        char bytes[8];
+        for (std::size_t i = 0; i < 8; ++i)
+            bytes[i] = static_cast<char>(bits >> (8 * i));
+        writeBytes(bytes, 8);
+    }
+
+    void flush()
+    {
+        mGood = mGood && mBuffer != nullptr &&
+            mBuffer->sputn(mBytes, static_cast<std::streamsize>(mSize)) == static_cast<std::streamsize>(mSize);
+        mSize = 0;
+    }
+
+    bool isGood() const
+    {
+        return mGood;
+    }
+
+    std::size_t getNbBytes() const
+    {
+        return mNbBytes;
+    }
+
+private:
+    static constexpr std::size_t BUFFER_SIZE = 4096;
+
+    std::streambuf* mBuffer;
+    char mBytes[BUFFER_SIZE];
+    std::size_t mSize = 0;
+    bool mGood = true;
+    std::size_t mNbBytes = 0;
+};
+
+class Reader
+{
+public:
+    explicit Reader(std::istream& stream) : mBuffer(stream.rdbuf())
+    {
+        if (mBuffer == nullptr)
+            throw std::runtime_error("The stream has no buffer");
+    }
+
+    void readBytes(char* bytes, std::size_t nbBytes)
+    {
+        if (mBuffer->sgetn(bytes, static_cast<std::streamsize>(nbBytes)) != static_cast<std::streamsize>(nbBytes))
+            throw std::runtime_error("The encoded diagram is truncated");
+    }
+
+    std::uint64_t readVarint()
+    {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            auto byte = mBuffer->sbumpc();
+            if (byte == std::char_traits<char>::eof())
+                throw std::runtime_error("The encoded diagram is truncated");
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        throw std::runtime_error("Invalid varint in the encoded diagram");
+    }
+
+    double readDouble()
+    {
+        unsigned char bytes[8];
+        readBytes(reinterpret_cast<char*>(bytes), 8);
+        std::uint64_t bits = 0;
+        for (std::size_t i = 0; i < 8; ++i)
+            bits |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+        double x;
+        std::memcpy(&x, &bits, sizeof(double));
+        return x;
+    }
+
+    Index readIndex(std::size_t size)
+    {
+        std::uint64_t index = readVarint();
+        if (index >= size)
+            throw std::runtime_error("Invalid index in the encoded diagram");
+        return static_cast<Index>(index);
+    }
+
+private:
+    std::streambuf* mBuffer;
+};
+
+}
+
+std::size_t encodeDiagram(const FrozenDiagram& diagram, std::ostream& stream, int nbBits, Box box)
+{
+    if (nbBits < 0 || nbBits > MAX_NB_BITS)
+        throw std::invalid_argument("The number of bits of the quantization must be between 0 and 32");
+    if (nbBits > 0 && !(box.left < box.right && box.bottom < box.top))
+        throw std::invalid_argument("The quantization box is empty");
+    Writer writer(stream);
+    // Header
+    writer.writeBytes(MAGIC, sizeof(MAGIC));
+    writer.writeVarint(ENCODING_VERSION);
+    writer.writeVarint(static_cast<std::uint64_t>(nbBits));
+    writer.writeVarint(diagram.getNbSites());
+    writer.writeVarint(diagram.getNbVertices());
+    if (nbBits > 0)
+    {
+        writer.writeDouble(box.left);
+        writer.writeDouble(box.bottom);
+        writer.writeDouble(box.right);
+        writer.writeDouble(box.top);
+    }
+    // Sites, they are always exact
+    for (Index i = 0; i < diagram.getNbSites(); ++i)
+    {
+        writer.writeDouble(diagram.getSitePoint(i).x);
+        writer.writeDouble(diagram.getSitePoint(i).y);
+    }
+    // Vertices, the quantized coordinates are delta encoded as the vertices are created in sweep order
+    if (nbBits > 0)
+    {
+        Quantizer xQuantizer(box.left, box.right, nbBits);
+        Quantizer yQuantizer(box.bottom, box.top, nbBits);
+        std::int64_t previousX = 0;
+        std::int64_t previousY = 0;
+        for (Index i = 0; i < diagram.getNbVertices(); ++i)
+        {
+            std::int64_t x = xQuantizer.quantize(diagram.getVertexPoint(i).x);
+            std::int64_t y = yQuantizer.quantize(diagram.getVertexPoint(i).y);
+            writer.writeVarint(encodeZigZag(x - previousX));
+            writer.writeVarint(encodeZigZag(y - previousY));
+            previousX = x;
+            previousY = y;
+        }
+    }
+    else
+    {
+        for (Index i = 0; i < diagram.getNbVertices(); ++i)
+        {
+            writer.writeDouble(diagram.getVertexPoint(i).x);
+            writer.writeDouble(diagram.getVertexPoint(i).y);
+        }
+    }
+    // Faces, the lowest bit of each origin delta tells if the half edge is on the border
+    // The lowest bit of the length tells if the cycle is open, then the destination of the last half edge and the
+    // position of the outer component in the chain follow
+    std::vector<Index> cycle;
+    std::int64_t previousOrigin = 0;
+    auto writeVertex = [&writer, &previousOrigin](Index vertex, bool border)
+    {
+        if (vertex == FrozenDiagram::INVALID_INDEX)
+            throw std::invalid_argument("The diagram must be bounded");
+        writer.writeVarint(encodeZigZag(static_cast<std::int64_t>(vertex) - previousOrigin) << 1 |
+            static_cast<std::uint64_t>(border));
+        previousOrigin = vertex;
+    };
+    for (Index face = 0; face < diagram.getNbSites(); ++face)
+    {
+        cycle.clear();
+        Index start = diagram.getOuterComponent(face);
+        for (Index halfEdge = start; halfEdge != FrozenDiagram::INVALID_INDEX; halfEdge = diagram.getNext(halfEdge))
+        {
+            if (cycle.size() >= diagram.getNbHalfEdges())
+                throw std::invalid_argument("A face of the diagram is not a chain");
+            cycle.push_back(halfEdge);
+            if (diagram.getNext(halfEdge) == start)
+                break;
+        }
+        // An open chain may begin before the outer component
+        bool open = !cycle.empty() && diagram.getNext(cycle.back()) == FrozenDiagram::INVALID_INDEX;
+        std::size_t nbNextHalfEdges = cycle.size();
+        if (open)
+        {
+            for (Index halfEdge = diagram.getPrev(start); halfEdge != FrozenDiagram::INVALID_INDEX;
+                halfEdge = diagram.getPrev(halfEdge))
+            {
+                if (cycle.size() >= diagram.getNbHalfEdges())
+                    throw std::invalid_argument("A face of the diagram is not a chain");
+                cycle.push_back(halfEdge);
+            }
+            std::reverse(cycle.begin() + nbNextHalfEdges, cycle.end());
+            std::rotate(cycle.begin(), cycle.begin() + nbNextHalfEdges, cycle.end());
+        }
+        writer.writeVarint(static_cast<std::uint64_t>(cycle.size()) << 1 | static_cast<std::uint64_t>(open));
+        for (Index halfEdge : cycle)
+        {
+            bool border = diagram.getIncidentFace(FrozenDiagram::getTwin(halfEdge)) == FrozenDiagram::INVALID_INDEX;
+            writeVertex(diagram.getOrigin(halfEdge), border);
+        }
+        if (open)
+        {
+            writeVertex(diagram.getDestination(cycle.back()), false);
+            writer.writeVarint(cycle.size() - nbNextHalfEdges);
+        }
+    }
+    writer.flush();
+    if (!writer.isGood())
+        throw std::runtime_error("Impossible to write the encoded diagram");
+    return writer.getNbBytes();
+}
+
+FrozenDiagram decodeDiagram(std::istream& stream)
+{
+    Reader reader(stream);
+    // Header
+    char magic[sizeof(MAGIC)];
+    reader.readBytes(magic, sizeof(MAGIC));
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error("The stream does not contain an encoded diagram");
+    std::uint64_t version = reader.readVarint();
+    if (version != ENCODING_VERSION)
+        throw std::runtime_error("The encoded diagram has version " + std::to_string(version) + " instead of " +
+            std::to_string(ENCODING_VERSION));
+    auto nbBits = static_cast<int>(reader.readIndex(MAX_NB_BITS + 1));
+    std::size_t nbSites = reader.readIndex(FrozenDiagram::INVALID_INDEX);
+    std::size_t nbVertices = reader.readIndex(FrozenDiagram::INVALID_INDEX);
+    Box box{};
+    if (nbBits > 0)
+    {
+        box.left = reader.readDouble();
+        box.bottom = reader.readDouble();
+        box.right = reader.readDouble();
+        box.top = reader.readDouble();
+        if (!(box.left < box.right && box.bottom < box.top))
+            throw std::runtime_error("The quantization box of the encoded diagram is empty");
+    }
+    // Sites
+    std::vector<Vector2> sitePoints;
+    sitePoints.reserve(nbSites);
+    for (std::size_t i = 0; i < nbSites; ++i)
+    {
+        double x = reader.readDouble();
+        sitePoints.emplace_back(x, reader.readDouble());
+    }
+    // Vertices
+    std::vector<Vector2> vertexPoints;
+    vertexPoints.reserve(nbVertices);
+    if (nbBits > 0)
+    {
+        Quantizer xQuantizer(box.left, box.right, nbBits);
+        Quantizer yQuantizer(box.bottom, box.top, nbBits);
+        std::int64_t x = 0;
+        std::int64_t y = 0;
+        for (std::size_t i = 0; i < nbVertices; ++i)
+        {
+            x += decodeZigZag(reader.readVarint());
+            y += decodeZigZag(reader.readVarint());
+            vertexPoints.emplace_back(xQuantizer.dequantize(x), yQuantizer.dequantize(y));
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < nbVertices; ++i)
+        {
+            double x = reader.readDouble();
+            vertexPoints.emplace_back(x, reader.readDouble());
+        }
+    }
+    // Faces, the twin of a half edge from u to v waits in the list of u until the half edge from v to u is read
+    // The lists are short as the vertices have a small degree, they are linked with the next field of the twins
+    // and the expected destination is stored in their prev field
+    std::vector<Index> outerComponents(nbSites, FrozenDiagram::INVALID_INDEX);
+    std::vector<FrozenDiagram::HalfEdge> halfEdges;
+    halfEdges.reserve(AVERAGE_NB_HALF_EDGES_PER_FACE * nbSites);
+    std::vector<Index> pendingTwins(nbVertices, FrozenDiagram::INVALID_INDEX);
+    std::size_t nbPendingTwins = 0;
+    std::vector<Index> origins;
+    std::vector<char> borders;
+    std::vector<Index> cycle;
+    std::int64_t previousOrigin = 0;
+    auto readVertex = [&reader, &previousOrigin, nbVertices](bool& border)
+    {
+        std::uint64_t value = reader.readVarint();
+        previousOrigin += decodeZigZag(value >> 1);
+        if (previousOrigin < 0 || static_cast<std::uint64_t>(previousOrigin) >= nbVertices)
+            throw std::runtime_error("Invalid vertex in the encoded diagram");
+        border = (value & 1) != 0;
+        return static_cast<Index>(previousOrigin);
+    };
+    for (std::size_t face = 0; face < nbSites; ++face)
+    {
+        std::uint64_t header = reader.readVarint();
+        std::size_t length = header >> 1;
+        bool open = (header & 1) != 0;
+        if (length >= FrozenDiagram::INVALID_INDEX || (open && length == 0))
+            throw std::runtime_error("Invalid face in the encoded diagram");
+        origins.clear();
+        borders.clear();
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            bool border;
+            origins.push_back(readVertex(border));
+            borders.push_back(border);
+        }
+        bool border;
+        Index lastDestination = open ? readVertex(border) : (length > 0 ? origins.front() : FrozenDiagram::INVALID_INDEX);
+        std::size_t outerComponent = open ? reader.readIndex(length) : 0;
+        // Assign the indices
+        cycle.clear();
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            Index origin = origins[i];
+            Index destination = i + 1 < length ? origins[i + 1] : lastDestination;
+            if (!borders[i])
+            {
+                Index* link = &pendingTwins[origin];
+                while (*link != FrozenDiagram::INVALID_INDEX && halfEdges[*link].prev != destination)
+                    link = &halfEdges[*link].next;
+                if (*link != FrozenDiagram::INVALID_INDEX)
+                {
+                    cycle.push_back(*link);
+                    *link = halfEdges[*link].next;
+                    --nbPendingTwins;
+                    continue;
+                }
+            }
+            if (halfEdges.size() + 2 >= FrozenDiagram::INVALID_INDEX)
+                throw std::runtime_error("The encoded diagram is too large");
+            auto i0 = static_cast<Index>(halfEdges.size());
+            Index i1 = FrozenDiagram::getTwin(i0);
+            cycle.push_back(i0);
+            halfEdges.resize(halfEdges.size() + 2, FrozenDiagram::HalfEdge{FrozenDiagram::INVALID_INDEX,
+                FrozenDiagram::INVALID_INDEX, FrozenDiagram::INVALID_INDEX, FrozenDiagram::INVALID_INDEX});
+            // The destination of a border half edge is stored in a twin without face
+            halfEdges[i1].origin = destination;
+            if (!borders[i])
+            {
+                halfEdges[i1].prev = origin;
+                halfEdges[i1].next = pendingTwins[destination];
+                pendingTwins[destination] = i1;
+                ++nbPendingTwins;
+            }
+        }
+        // Link the cycle
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            Index prev = i > 0 ? cycle[i - 1] : (open ? FrozenDiagram::INVALID_INDEX : cycle.back());
+            Index next = i + 1 < length ? cycle[i + 1] : (open ? FrozenDiagram::INVALID_INDEX : cycle.front());
+            halfEdges[cycle[i]] = FrozenDiagram::HalfEdge{origins[i], static_cast<Index>(face), prev, next};
+        }
+        if (length > 0)
+            outerComponents[face] = cycle[outerComponent];
+    }
+    if (nbPendingTwins > 0)
+        throw std::runtime_error("Some half edges of the encoded diagram have no twin");
+    return FrozenDiagram(std::move(sitePoints), std::move(outerComponents), std::move(vertexPoints),
+        std::move(halfEdges));
+}
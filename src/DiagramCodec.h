@@ -0,0 +1,39 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>
+#include <iosfwd>
+// My includes
+#include "Box.h"
+#include "FrozenDiagram.h"
+
+// Compact encoding of a frozen diagram to move it between hosts, it does not depend on the byte order
+// Each face is written as the cycle of its half edge origins, the indices are delta encoded and packed in varints.
+// The twins are not stored, the decoder pairs the half edges with opposite origins and destinations.
+
+// The vertices are quantized on nbBits bits (at most 32) relative to box, or stored exactly if nbBits is 0
+// The quantized coordinates are clamped to the box
+// Throws std::invalid_argument if a half edge has no origin, std::runtime_error if the stream can not be written
+// Returns the number of written bytes
+std::size_t encodeDiagram(const FrozenDiagram& diagram, std::ostream& stream, int nbBits = 0, Box box = Box{});
+
+// The stream is read as the diagram is rebuilt and not beyond the end of the encoded diagram
+// Throws std::runtime_error if the stream ends early or is not a valid encoded diagram
+FrozenDiagram decodeDiagram(std::istream& stream);
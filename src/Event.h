@@ -21,29 +21,51 @@
 #include "Vector2.h"
 #include "VoronoiDiagram.h"
 
-class Arc;
+template<typename T>
+struct BasicArc;
 
-class Event
+// Compact event, its y-coordinate is stored in the event queue
+template<typename T>
+class BasicEvent
 {
 public:
+    using Site = typename BasicVoronoiDiagram<T>::Site;
+    using Arc = BasicArc<T>;
+
     enum class Type{SITE, CIRCLE};
 
     // Site event
-    Event(VoronoiDiagram::Site* site);
-    // Circle event
-    Event(double y, Vector2 point, Arc* arc);
+    explicit BasicEvent(Site* site) : type(Type::SITE), site(site)
+    {
+
+    }
 
-    const Type type;
-    double y;
-    int index;
-    // Site event
-    VoronoiDiagram::Site* site;
     // Circle event
-    Vector2 point;
-    Arc* arc;
+    BasicEvent(BasicVector2<T> point, Arc* arc) : type(Type::CIRCLE), arc(arc), point(point)
+    {
 
+    }
+
+    Type type;
+    union
+    {
+        // Site event
+        Site* site;
+        // Circle event
+        Arc* arc;
+    };
+    // Circle event
+    BasicVector2<T> point;
 };
 
-bool operator<(const Event& lhs, const Event& rhs);
-std::ostream& operator<<(std::ostream& os, const Event& event);
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const BasicEvent<T>& event)
+{
+    if(event.type == BasicEvent<T>::Type::SITE)
+        os << "S(" << event.site->index << ")";
+    else
+        os << "C(" << event.arc << ", " << event.point << ")";
+    return os;
+}
 
+using Event = BasicEvent<double>;
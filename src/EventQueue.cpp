@@ -0,0 +1,176 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EventQueue.h"
+
+template<typename T>
+constexpr typename BasicEventQueue<T>::Handle BasicEventQueue<T>::INVALID_HANDLE;
+
+template<typename T>
+BasicEventQueue<T>::BasicEventQueue() : mFreeHandle(INVALID_HANDLE)
+{
+
+}
+
+template<typename T>
+bool BasicEventQueue<T>::isEmpty() const
+{
+    return mHeap.empty();
+}
+
+template<typename T>
+std::size_t BasicEventQueue<T>::getSize() const
+{
+    return mHeap.size();
+}
+
+template<typename T>
+T BasicEventQueue<T>::getTopY() const
+{
+    return mHeap.front().y;
+}
+
+template<typename T>
+void BasicEventQueue<T>::reserve(std::size_t capacity)
+{
+    mHeap.reserve(capacity);
+    mEvents.reserve(capacity);
+    mPositions.reserve(capacity);
+}
+
+template<typename T>
+void BasicEventQueue<T>::clear()
+{
+    mHeap.clear();
+    mEvents.clear();
+    mPositions.clear();
+    mFreeHandle = INVALID_HANDLE;
+}
+
+template<typename T>
+typename BasicEventQueue<T>::Handle BasicEventQueue<T>::push(T y, const Event& event)
+{
+    Handle handle = allocateHandle(event);
+    mPositions[handle] = static_cast<Handle>(mHeap.size());
+    mHeap.push_back(Node{y, handle, event.type == Event::Type::SITE});
+    siftUp(mHeap.size() - 1);
+    return handle;
+}
+
+template<typename T>
+BasicEvent<T> BasicEventQueue<T>::pop()
+{
+    Handle handle = mHeap.front().handle;
+    Event event = mEvents[handle];
+    freeHandle(handle);
+    mHeap.front() = mHeap.back();
+    mHeap.pop_back();
+    if (!mHeap.empty())
+    {
+        mPositions[mHeap.front().handle] = 0;
+        siftDown(0);
+    }
+    return event;
+}
+
+template<typename T>
+void BasicEventQueue<T>::remove(Handle handle)
+{
+    std::size_t i = mPositions[handle];
+    freeHandle(handle);
+    mHeap[i] = mHeap.back();
+    mHeap.pop_back();
+    if (i < mHeap.size())
+    {
+        mPositions[mHeap[i].handle] = static_cast<Handle>(i);
+        update(i);
+    }
+}
+
+template<typename T>
+typename BasicEventQueue<T>::Handle BasicEventQueue<T>::allocateHandle(const Event& event)
+{
+    if (mFreeHandle != INVALID_HANDLE)
+    {
+        Handle handle = mFreeHandle;
+        mFreeHandle = mPositions[handle];
+        mEvents[handle] = event;
+        return handle;
+    }
+    mEvents.push_back(event);
+    mPositions.push_back(INVALID_HANDLE);
+    return static_cast<Handle>(mEvents.size() - 1);
+}
+
+template<typename T>
+void BasicEventQueue<T>::freeHandle(Handle handle)
+{
+    mPositions[handle] = mFreeHandle;
+    mFreeHandle = handle;
+}
+
+template<typename T>
+void BasicEventQueue<T>::update(std::size_t i)
+{
+    if (i > 0 && mHeap[(i - 1) / 2] < mHeap[i])
+        siftUp(i);
+    else
+        siftDown(i);
+}
+
+template<typename T>
+void BasicEventQueue<T>::siftUp(std::size_t i)
+{
+    Node node = mHeap[i];
+    while (i > 0)
+    {
+        std::size_t parent = (i - 1) / 2;
+        if (!(mHeap[parent] < node))
+            break;
+        mHeap[i] = mHeap[parent];
+        mPositions[mHeap[i].handle] = static_cast<Handle>(i);
+        i = parent;
+    }
+    mHeap[i] = node;
+    mPositions[node.handle] = static_cast<Handle>(i);
+}
+
+template<typename T>
+void BasicEventQueue<T>::siftDown(std::size_t i)
+{
+    Node node = mHeap[i];
+    std::size_t size = mHeap.size();
+    while (true)
+    {
+        std::size_t j = 2 * i + 1;
+        if (j >= size)
+            break;
+        if (j + 1 < size && mHeap[j] < mHeap[j + 1])
+            ++j;
+        if (!(node < mHeap[j]))
+            break;
+        mHeap[i] = mHeap[j];
+        mPositions[mHeap[i].handle] = static_cast<Handle>(i);
+        i = j;
+    }
+    mHeap[i] = node;
+    mPositions[node.handle] = static_cast<Handle>(i);
+}
+
+template class BasicEventQueue<float>;
+template class BasicEventQueue<double>;
+template class BasicEventQueue<long double>;
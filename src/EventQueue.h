@@ -0,0 +1,88 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstdint>
+#include <limits>
+#include <vector>
+// My includes
+#include "Event.h"
+
+// Binary max-heap on the y-coordinates of the events
+// The events are stored by value in slots addressed by stable handles,
+// the heap itself only moves (y, handle) pairs
+template<typename T>
+class BasicEventQueue
+{
+public:
+    using Scalar = T;
+    using Event = BasicEvent<T>;
+    using Handle = std::uint32_t;
+    static constexpr Handle INVALID_HANDLE = std::numeric_limits<Handle>::max();
+
+    BasicEventQueue();
+
+    // Accessors
+
+    bool isEmpty() const;
+    std::size_t getSize() const;
+    T getTopY() const;
+
+    // Operations
+
+    void reserve(std::size_t capacity);
+    void clear();
+    Handle push(T y, const Event& event);
+    Event pop();
+    void remove(Handle handle);
+
+private:
+    struct Node
+    {
+        T y;
+        Handle handle;
+        bool isSite;
+
+        // At the same y, the circle events are handled before the site events
+        bool operator<(const Node& node) const
+        {
+            return y < node.y || (y == node.y && isSite && !node.isSite);
+        }
+    };
+
+    std::vector<Node> mHeap;
+    std::vector<Event> mEvents;
+    std::vector<Handle> mPositions; // Position in the heap, or next free handle for free slots
+    Handle mFreeHandle;
+
+    // Handles
+    Handle allocateHandle(const Event& event);
+    void freeHandle(Handle handle);
+
+    // Operations
+    void update(std::size_t i);
+    void siftUp(std::size_t i);
+    void siftDown(std::size_t i);
+};
+
+extern template class BasicEventQueue<float>;
+extern template class BasicEventQueue<double>;
+extern template class BasicEventQueue<long double>;
+
+using EventQueue = BasicEventQueue<double>;
@@ -16,54 +16,332 @@
  */
 
 #include "FortuneAlgorithm.h"
+// STL
+#include <algorithm>
+#include <limits>
 // My includes
 #include "Arc.h"
 #include "Event.h"
+#include "IntegerPredicates.h"
 
-FortuneAlgorithm::FortuneAlgorithm(std::vector<Vector2> points) : mDiagram(std::move(points))
+namespace
+{
+
+// Order of the sites by decreasing y, the sites with the same y stay in increasing order of index
+template<typename T>
+void sortByDecreasingY(const BasicVoronoiDiagram<T>& diagram, std::vector<std::uint64_t>& keys,
+    std::vector<std::uint32_t>& order, RadixSortBuffers& buffers)
+{
+    keys.resize(diagram.getNbSites());
+    order.resize(diagram.getNbSites());
+    for (std::size_t i = 0; i < diagram.getNbSites(); ++i)
+    {
+        keys[i] = ~getRadixKey(diagram.getSite(i)->point.y);
+        order[i] = static_cast<std::uint32_t>(i);
+    }
+    radixSort(keys, order, buffers);
+}
+
+// There is no 64-bit key with the ordering of long doubles, the sites are sorted with comparisons
+void sortByDecreasingY(const BasicVoronoiDiagram<long double>& diagram, std::vector<std::uint64_t>&,
+    std::vector<std::uint32_t>& order, RadixSortBuffers&)
+{
+    order.resize(diagram.getNbSites());
+    for (std::size_t i = 0; i < diagram.getNbSites(); ++i)
+        order[i] = static_cast<std::uint32_t>(i);
+    std::sort(order.begin(), order.end(), [&diagram](std::uint32_t i, std::uint32_t j)
+    {
+        long double yi = diagram.getSite(i)->point.y;
+        long double yj = diagram.getSite(j)->point.y;
+        return yi > yj || (yi == yj && i < j);
+    });
+}
+
+}
+
+template<typename B, typename Q>
+constexpr std::uint32_t BasicFortuneAlgorithm<B, Q>::NO_INDEX;
+template<typename B, typename Q>
+constexpr std::uint32_t BasicFortuneAlgorithm<B, Q>::EMITTED;
+
+template<typename B, typename Q>
+BasicFortuneAlgorithm<B, Q>::BasicFortuneAlgorithm(PointView points) :
+    mDiagram(points), mLocationMode(LocationMode::ROOT), mPredicateMode(PredicateMode::FLOATING),
+    mHint(nullptr), mTimings{}, mNbProcessedEvents(0), mFirstLineY(0), mCellCallback(nullptr), mStreamBox{}, mNbCircleEvents(0)
 {
 
 }
 
-FortuneAlgorithm::~FortuneAlgorithm() = default;
+template<typename B, typename Q>
+BasicFortuneAlgorithm<B, Q>::~BasicFortuneAlgorithm() = default;
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::reset(PointView points)
+{
+    mDiagram.reset(points);
+    mBeachline.reset();
+    mEvents.clear();
+    mBeachlineY = Scalar(0);
+    mHint = nullptr;
+    mTimings = Timings{};
+    mNbProcessedEvents = 0;
+    mStatistics = Statistics{};
+    mVerticalHalfEdges.clear();
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::reset(PointView points, VoronoiDiagram diagram)
+{
+    mDiagram = std::move(diagram);
+    reset(points);
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::construct(SiteEventMode mode, LocationMode locationMode, PredicateMode predicateMode)
+{
+    mCellCallback = nullptr;
+    sweep(mode, locationMode, predicateMode);
+    // Each circle event creates exactly one vertex
+    mNbProcessedEvents = mDiagram.getNbSites() + mDiagram.getVertices().getSize();
+}
 
-void FortuneAlgorithm::construct()
+template<typename B, typename Q>
+bool BasicFortuneAlgorithm<B, Q>::stream(Box box, const CellCallback& callback, SiteEventMode mode,
+    LocationMode locationMode, PredicateMode predicateMode)
 {
-    // Initialize event queue
+    // Release the storage reserved for a whole diagram, the recycled elements are used instead
+    mDiagram.mVertices = StableVector<Vertex>();
+    mDiagram.mHalfEdges = StableVector<HalfEdge>();
+    mCellCallback = &callback;
+    mStreamBox = box;
+    mNbCircleEvents = 0;
+    mNbSiteArcs.assign(mDiagram.getNbSites(), 0);
+    mVertexReferences.clear();
+    sweep(mode, locationMode, predicateMode);
+    mNbProcessedEvents = mDiagram.getNbSites() + mNbCircleEvents;
+    // Close the cells still in the beachline then give them with the ones that were not closed during the sweep
+    bool valid = bound(box);
     for (std::size_t i = 0; i < mDiagram.getNbSites(); ++i)
-        mEvents.push(std::make_unique<Event>(mDiagram.getSite(i)));
+    {
+        if (mNbSiteArcs[i] != EMITTED && !emitCell(i))
+        {
+            valid = false;
+            mCell.site = i;
+            mCell.vertices.clear();
+            callback(mCell);
+        }
+    }
+    mDiagram.removeCells();
+    mCellCallback = nullptr;
+    return valid;
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::sweep(SiteEventMode mode, LocationMode locationMode, PredicateMode predicateMode)
+{
+    mLocationMode = locationMode;
+    mPredicateMode = predicateMode;
+    mBeachline.setIntegerSites(predicateMode == PredicateMode::INTEGER);
+    auto start = std::chrono::steady_clock::now();
+    if (mode == SiteEventMode::HEAP)
+    {
+        initializeHeap();
+        auto end = std::chrono::steady_clock::now();
+        mTimings.initialization = end - start;
+        sweepHeap();
+        mTimings.sweep = std::chrono::steady_clock::now() - end;
+    }
+    else
+    {
+        sortSites();
+        auto end = std::chrono::steady_clock::now();
+        mTimings.initialization = end - start;
+        sweepSorted();
+        mTimings.sweep = std::chrono::steady_clock::now() - end;
+    }
+#ifdef FORTUNE_STATISTICS
+    const Statistics& beachlineStatistics = mBeachline.getStatistics();
+    mStatistics.nbLocations = beachlineStatistics.nbLocations;
+    mStatistics.nbHintedLocations = beachlineStatistics.nbHintedLocations;
+    mStatistics.nbLocationSteps = beachlineStatistics.nbLocationSteps;
+    mStatistics.nbRootLocationSteps = beachlineStatistics.nbRootLocationSteps;
+    mStatistics.nbRotations = beachlineStatistics.nbRotations;
+#endif
+}
+
+template<typename B, typename Q>
+typename BasicFortuneAlgorithm<B, Q>::VoronoiDiagram BasicFortuneAlgorithm<B, Q>::getDiagram()
+{
+    return std::move(mDiagram);
+}
 
-    // Process events
+template<typename B, typename Q>
+const B& BasicFortuneAlgorithm<B, Q>::getBeachline() const
+{
+    return mBeachline;
+}
+
+template<typename B, typename Q>
+const FortuneAlgorithmBase::Timings& BasicFortuneAlgorithm<B, Q>::getTimings() const
+{
+    return mTimings;
+}
+
+template<typename B, typename Q>
+std::size_t BasicFortuneAlgorithm<B, Q>::getNbProcessedEvents() const
+{
+    return mNbProcessedEvents;
+}
+
+template<typename B, typename Q>
+const Statistics& BasicFortuneAlgorithm<B, Q>::getStatistics() const
+{
+    return mStatistics;
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::initializeHeap()
+{
+    // The sites of the first line are kept apart to be processed from left to right
+    Scalar maxY = -std::numeric_limits<Scalar>::infinity();
+    for (std::size_t i = 0; i < mDiagram.getNbSites(); ++i)
+        maxY = std::max(maxY, mDiagram.getSite(i)->point.y);
+    mFirstLineY = maxY;
+    mSiteOrder.clear();
+    mEvents.reserve(2 * mDiagram.getNbSites());
+    for (std::size_t i = 0; i < mDiagram.getNbSites(); ++i)
+    {
+        Site* site = mDiagram.getSite(i);
+        if (site->point.y == maxY)
+            mSiteOrder.push_back(static_cast<std::uint32_t>(i));
+        else
+            mEvents.push(site->point.y, Event(site));
+    }
+    FORTUNE_STATISTICS_ONLY(mStatistics.maxEventQueueSize = mEvents.getSize());
+    sortFirstLine(mSiteOrder.begin(), mSiteOrder.end());
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::sweepHeap()
+{
+    for (std::uint32_t i : mSiteOrder)
+    {
+        Site* site = mDiagram.getSite(i);
+        mBeachlineY = site->point.y;
+        handleSiteEvent(Event(site));
+    }
     while (!mEvents.isEmpty())
     {
-        std::unique_ptr<Event> event = mEvents.pop();
-        mBeachlineY = event->y;
-        if(event->type == Event::Type::SITE)
-            handleSiteEvent(event.get());
+        mBeachlineY = mEvents.getTopY();
+        Event event = mEvents.pop();
+        if(event.type == Event::Type::SITE)
+            handleSiteEvent(event);
         else
-            handleCircleEvent(event.get());
+            handleCircleEvent(event);
     }
 }
 
-VoronoiDiagram FortuneAlgorithm::getDiagram()
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::sortSites()
 {
-    return std::move(mDiagram);
+    sortByDecreasingY(mDiagram, mSiteKeys, mSiteOrder, mSortBuffers);
+    // The sites of the first line are processed from left to right
+    if (!mSiteOrder.empty())
+    {
+        Scalar maxY = mDiagram.getSite(mSiteOrder.front())->point.y;
+        mFirstLineY = maxY;
+        auto end = std::find_if(mSiteOrder.begin(), mSiteOrder.end(), [this, maxY](std::uint32_t i)
+        {
+            return mDiagram.getSite(i)->point.y != maxY;
+        });
+        sortFirstLine(mSiteOrder.begin(), end);
+    }
 }
 
-void FortuneAlgorithm::handleSiteEvent(Event* event)
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::sweepSorted()
 {
-    VoronoiDiagram::Site* site = event->site;
+    auto it = mSiteOrder.begin();
+    while (it != mSiteOrder.end() || !mEvents.isEmpty())
+    {
+        // Circle events are processed first in case of equality
+        if (it == mSiteOrder.end() || (!mEvents.isEmpty() && mEvents.getTopY() >= mDiagram.getSite(*it)->point.y))
+        {
+            mBeachlineY = mEvents.getTopY();
+            handleCircleEvent(mEvents.pop());
+        }
+        else
+        {
+            Site* site = mDiagram.getSite(*it++);
+            mBeachlineY = site->point.y;
+            handleSiteEvent(Event(site));
+        }
+    }
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::sortFirstLine(std::vector<std::uint32_t>::iterator begin,
+    std::vector<std::uint32_t>::iterator end)
+{
+    std::sort(begin, end, [this](std::uint32_t i, std::uint32_t j)
+    {
+        return mDiagram.getSite(i)->point.x < mDiagram.getSite(j)->point.x;
+    });
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::handleSiteEvent(const Event& event)
+{
+    Site* site = event.site;
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbSiteEvents);
     // 1. Check if the bachline is empty
     if (mBeachline.isEmpty())
     {
-        mBeachline.setRoot(mBeachline.createArc(site));
+        mHint = mBeachline.createArc(site);
+        mBeachline.setRoot(mHint);
+        if (mCellCallback != nullptr)
+            ++mNbSiteArcs[site->index];
         return;
     }
     // 2. Look for the arc above the site
-    Arc* arcToBreak = mBeachline.locateArcAbove(site->point, mBeachlineY);
+    Arc* arcToBreak = mLocationMode == LocationMode::HINT ?
+        mBeachline.locateArcAbove(site->point, mBeachlineY, mHint) :
+        mBeachline.locateArcAbove(site->point, mBeachlineY);
+    // The coincident sites are skipped, only the first one has a cell
+    if (isCoincident(arcToBreak, site))
+    {
+        if (mCellCallback != nullptr)
+            emitCell(site->index);
+        return;
+    }
+    // The sites of the first line are added from left to right and separated by vertical lines
+    if (site->point.y == mFirstLineY)
+    {
+        Arc* arc = mBeachline.createArc(site);
+        mBeachline.insertAfter(arcToBreak, arc);
+        mHint = arc;
+        addEdge(arcToBreak, arc);
+        mVerticalHalfEdges.push_back(arcToBreak->rightHalfEdge);
+        // The cells of the first line are unbounded at the top, they are pinned until the end
+        if (mCellCallback != nullptr)
+        {
+            mNbSiteArcs[site->index] += 2;
+            ++mNbSiteArcs[arcToBreak->site->index];
+        }
+        FORTUNE_STATISTICS_ONLY(mStatistics.maxBeachlineSize = std::max(mStatistics.maxBeachlineSize, mBeachline.getNbArcs()));
+        return;
+    }
     deleteEvent(arcToBreak);
+    // The broken arc is replaced by two arcs
+    if (mCellCallback != nullptr)
+    {
+        ++mNbSiteArcs[site->index];
+        ++mNbSiteArcs[arcToBreak->site->index];
+    }
     // 3. Replace this arc by the new arcs
     Arc* middleArc = breakArc(arcToBreak, site);
+    mHint = middleArc;
+    FORTUNE_STATISTICS_ONLY(mStatistics.maxBeachlineSize = std::max(mStatistics.maxBeachlineSize, mBeachline.getNbArcs()));
     Arc* leftArc = middleArc->prev; 
     Arc* rightArc = middleArc->next;
     // 4. Add an edge in the diagram
@@ -71,37 +349,41 @@ void FortuneAlgorithm::handleSiteEvent(Event* event)
     middleArc->rightHalfEdge = middleArc->leftHalfEdge;
     rightArc->leftHalfEdge = leftArc->rightHalfEdge;
     // 5. Check circle events
-    // Left triplet
-    if (!mBeachline.isNil(leftArc->prev))
-        addEvent(leftArc->prev, leftArc, middleArc);
-    // Right triplet
-    if (!mBeachline.isNil(rightArc->next))
-        addEvent(middleArc, rightArc, rightArc->next);
+    addEvents(leftArc, rightArc);
 }
 
-void FortuneAlgorithm::handleCircleEvent(Event* event)
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::handleCircleEvent(const Event& event)
 {
-    Vector2 point = event->point;
-    Arc* arc = event->arc;
+    Vector2 point = event.point;
+    Arc* arc = event.arc;
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbCircleEvents);
     // 1. Add vertex
-    VoronoiDiagram::Vertex* vertex = mDiagram.createVertex(point);
+    Vertex* vertex = mDiagram.createVertex(point);
     // 2. Delete all the events with this arc
     Arc* leftArc = arc->prev;
     Arc* rightArc = arc->next;
     deleteEvent(leftArc);
     deleteEvent(rightArc);
     // 3. Update the beachline and the diagram
+    std::size_t site = arc->site->index;
     removeArc(arc, vertex);
     // 4. Add new circle events
-    // Left triplet
-    if (!mBeachline.isNil(leftArc->prev))
-        addEvent(leftArc->prev, leftArc, rightArc);
-    // Right triplet
-    if (!mBeachline.isNil(rightArc->next))
-        addEvent(leftArc, rightArc, rightArc->next);
+    addEvents(leftArc, rightArc);
+    // 5. Give the cell if it was the last arc of its site, the vertex is shared by three cells
+    if (mCellCallback != nullptr)
+    {
+        ++mNbCircleEvents;
+        if (vertex->index >= mVertexReferences.size())
+            mVertexReferences.resize(vertex->index + 1);
+        mVertexReferences[vertex->index] = 3;
+        if (--mNbSiteArcs[site] == 0 && emitCell(site))
+            recycleCell();
+    }
 }
 
-Arc* FortuneAlgorithm::breakArc(Arc* arc, VoronoiDiagram::Site* site)
+template<typename B, typename Q>
+typename BasicFortuneAlgorithm<B, Q>::Arc* BasicFortuneAlgorithm<B, Q>::breakArc(Arc* arc, Site* site)
 {
     // Create the new subtree
     Arc* middleArc = mBeachline.createArc(site);
@@ -114,12 +396,25 @@ Arc* FortuneAlgorithm::breakArc(Arc* arc, VoronoiDiagram::Site* site)
     mBeachline.insertBefore(middleArc, leftArc);
     mBeachline.insertAfter(middleArc, rightArc);
     // Delete old arc
-    delete arc;
+    mBeachline.deleteArc(arc);
     // Return the middle arc
     return middleArc;
 }
 
-void FortuneAlgorithm::removeArc(Arc* arc, VoronoiDiagram::Vertex* vertex)
+template<typename B, typename Q>
+bool BasicFortuneAlgorithm<B, Q>::isCoincident(const Arc* arc, const Site* site) const
+{
+    // The arc of a previous site with the same point has a null width, the located arc is either it or a neighbor
+    auto hasPoint = [this, site](const Arc* other)
+    {
+        return !mBeachline.isNil(other) && other->site->point.x == site->point.x &&
+            other->site->point.y == site->point.y;
+    };
+    return hasPoint(arc) || hasPoint(arc->prev) || hasPoint(arc->next);
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::removeArc(Arc* arc, Vertex* vertex)
 {
     // End edges
     setDestination(arc->prev, arc, vertex);
@@ -129,28 +424,21 @@ void FortuneAlgorithm::removeArc(Arc* arc, VoronoiDiagram::Vertex* vertex)
     arc->rightHalfEdge->prev = arc->leftHalfEdge;
     // Update beachline
     mBeachline.remove(arc);
+    if (mHint == arc)
+        mHint = arc->prev;
     // Create a new edge
-    VoronoiDiagram::HalfEdge* prevHalfEdge = arc->prev->rightHalfEdge;
-    VoronoiDiagram::HalfEdge* nextHalfEdge = arc->next->leftHalfEdge;
+    HalfEdge* prevHalfEdge = arc->prev->rightHalfEdge;
+    HalfEdge* nextHalfEdge = arc->next->leftHalfEdge;
     addEdge(arc->prev, arc->next);
     setOrigin(arc->prev, arc->next, vertex);
     setPrevHalfEdge(arc->prev->rightHalfEdge, prevHalfEdge);
     setPrevHalfEdge(nextHalfEdge, arc->next->leftHalfEdge);
     // Delete node
-    delete arc;
-}
-
-bool FortuneAlgorithm::isMovingRight(const Arc* left, const Arc* right) const
-{
-    return left->site->point.y < right->site->point.y;
-}
-
-double FortuneAlgorithm::getInitialX(const Arc* left, const Arc* right, bool movingRight) const
-{
-    return movingRight ? left->site->point.x : right->site->point.x;
+    mBeachline.deleteArc(arc);
 }
 
-void FortuneAlgorithm::addEdge(Arc* left, Arc* right)
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::addEdge(Arc* left, Arc* right)
 {
     // Create two new half edges
     left->rightHalfEdge = mDiagram.createHalfEdge(left->site->face);
@@ -160,166 +448,454 @@ void FortuneAlgorithm::addEdge(Arc* left, Arc* right)
     right->leftHalfEdge->twin = left->rightHalfEdge;
 }
 
-void FortuneAlgorithm::setOrigin(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex)
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::setOrigin(Arc* left, Arc* right, Vertex* vertex)
 {
     left->rightHalfEdge->destination = vertex;
     right->leftHalfEdge->origin = vertex;
 }
 
-void FortuneAlgorithm::setDestination(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex)
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::setDestination(Arc* left, Arc* right, Vertex* vertex)
 {
     left->rightHalfEdge->origin = vertex;
     right->leftHalfEdge->destination = vertex;
 }
 
-void FortuneAlgorithm::setPrevHalfEdge(VoronoiDiagram::HalfEdge* prev, VoronoiDiagram::HalfEdge* next)
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::setPrevHalfEdge(HalfEdge* prev, HalfEdge* next)
 {
     prev->next = next;
     next->prev = prev;
 }
 
-void FortuneAlgorithm::addEvent(Arc* left, Arc* middle, Arc* right)
-{
-    double y;
-    Vector2 convergencePoint = computeConvergencePoint(left->site->point, middle->site->point, right->site->point, y);
-    bool isBelow = y <= mBeachlineY;
-    bool leftBreakpointMovingRight = isMovingRight(left, middle);
-    bool rightBreakpointMovingRight = isMovingRight(middle, right);
-    double leftInitialX = getInitialX(left, middle, leftBreakpointMovingRight);
-    double rightInitialX = getInitialX(middle, right, rightBreakpointMovingRight);
-    bool isValid =
-        ((leftBreakpointMovingRight && leftInitialX < convergencePoint.x) ||
-        (!leftBreakpointMovingRight && leftInitialX > convergencePoint.x)) &&
-        ((rightBreakpointMovingRight && rightInitialX < convergencePoint.x) ||
-        (!rightBreakpointMovingRight && rightInitialX > convergencePoint.x));
-    if (isValid && isBelow)
-    {
-        std::unique_ptr<Event> event = std::make_unique<Event>(y, convergencePoint, middle);
-        middle->event = event.get();
-        mEvents.push(std::move(event));
-    }
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::addEvents(Arc* left, Arc* right)
+{
+    // Orientations of the triplets centered on left and right, first for both of them
+    // Only the triplets turning clockwise converge, the others are rejected without computing their convergence point
+    Scalar leftOrientation = Scalar(0);
+    Scalar rightOrientation = Scalar(0);
+    bool hasLeftTriplet = !mBeachline.isNil(left->prev);
+    bool hasRightTriplet = !mBeachline.isNil(right->next);
+    if (hasLeftTriplet)
+        leftOrientation = computeOrientation(left->prev->site->point, left->site->point, left->next->site->point);
+    if (hasRightTriplet)
+        rightOrientation = computeOrientation(right->prev->site->point, right->site->point, right->next->site->point);
+    FORTUNE_STATISTICS_ONLY(mStatistics.nbTriplets += hasLeftTriplet + hasRightTriplet);
+    if (leftOrientation < 0.0)
+        addEvent(left->prev, left, left->next, leftOrientation);
+    if (rightOrientation < 0.0)
+        addEvent(right->prev, right, right->next, rightOrientation);
 }
 
-void FortuneAlgorithm::deleteEvent(Arc* arc)
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::addEvent(Arc* left, Arc* middle, Arc* right, Scalar orientation)
 {
-    if (arc->event != nullptr)
+    Scalar y;
+    Vector2 convergencePoint;
+    // With the integer predicates, y is exact relative to the sites but it may be rounded above the last circle event
+    if (mPredicateMode == PredicateMode::INTEGER)
+        convergencePoint = computeIntegerConvergencePoint(left->site->point, middle->site->point,
+            right->site->point, y);
+    else
+        convergencePoint = computeConvergencePoint(left->site->point, middle->site->point, right->site->point,
+            orientation, y);
+    // The triplet converges so its circle event is not above the beachline, it may only be rounded above it,
+    // for instance when the circle goes through the last site, it is then moved down to it
+    y = std::min(y, mBeachlineY);
+    middle->event = mEvents.push(y, Event(convergencePoint, middle));
+    FORTUNE_STATISTICS_ONLY(++mStatistics.nbCreatedCircleEvents);
+    FORTUNE_STATISTICS_ONLY(mStatistics.maxEventQueueSize = std::max(mStatistics.maxEventQueueSize, mEvents.getSize()));
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::deleteEvent(Arc* arc)
+{
+    if (arc->event != Q::INVALID_HANDLE)
     {
-        mEvents.remove(arc->event->index);
-        arc->event = nullptr;
+        mEvents.remove(arc->event);
+        arc->event = Q::INVALID_HANDLE;
+        FORTUNE_STATISTICS_ONLY(++mStatistics.nbDeletedCircleEvents);
     }
 }
 
-Vector2 FortuneAlgorithm::computeConvergencePoint(const Vector2& point1, const Vector2& point2, const Vector2& point3, double& y) const
+template<typename B, typename Q>
+typename BasicFortuneAlgorithm<B, Q>::Scalar BasicFortuneAlgorithm<B, Q>::computeOrientation(const Vector2& point1, const Vector2& point2,
+    const Vector2& point3) const
+{
+    if (mPredicateMode == PredicateMode::INTEGER)
+        return static_cast<Scalar>(computeIntegerOrientation(point1, point2, point3));
+    return (point1 - point2).getDet(point2 - point3);
+}
+
+template<typename B, typename Q>
+typename BasicFortuneAlgorithm<B, Q>::Vector2 BasicFortuneAlgorithm<B, Q>::computeConvergencePoint(
+    const Vector2& point1, const Vector2& point2, const Vector2& point3, Scalar orientation, Scalar& y) const
 {
     Vector2 v1 = (point1 - point2).getOrthogonal();
     Vector2 v2 = (point2 - point3).getOrthogonal();
     Vector2 delta = 0.5 * (point3 - point1);
-    double t = delta.getDet(v2) / v1.getDet(v2);
+    Scalar t = delta.getDet(v2) / orientation; // The orientation is equal to v1.getDet(v2)
     Vector2 center = 0.5 * (point1 + point2) + t * v1;
-    double r = center.getDistance(point1);
+    Scalar r = center.getDistance(point1);
     y = center.y - r;
     return center;
 }
 
 // Bound
 
-#include <list>
-#include <unordered_map>
-
-bool FortuneAlgorithm::bound(Box box)
+template<typename B, typename Q>
+bool BasicFortuneAlgorithm<B, Q>::bound(Box box)
 {
     // Make sure the bounding box contains all the vertices
-    for (const auto& vertex : mDiagram.getVertices()) // Much faster when using vector<unique_ptr<Vertex*>, maybe we can test vertices in border cells to speed up
-    {
-        box.left = std::min(vertex.point.x, box.left);
-        box.bottom = std::min(vertex.point.y, box.bottom);
-        box.right = std::max(vertex.point.x, box.right);
-        box.top = std::max(vertex.point.y, box.top);
-    }
+    box.left = std::min(mDiagram.mVertexBox.left, box.left);
+    box.bottom = std::min(mDiagram.mVertexBox.bottom, box.bottom);
+    box.right = std::max(mDiagram.mVertexBox.right, box.right);
+    box.top = std::max(mDiagram.mVertexBox.top, box.top);
+    resetBorderCells();
     // Retrieve all non bounded half edges from the beach line
-    std::list<LinkedVertex> linkedVertices;
-    std::unordered_map<std::size_t, std::array<LinkedVertex*, 8>> vertices(mDiagram.getNbSites());
     if (!mBeachline.isEmpty())
     {
+        // Line-box intersections of all the edges at once
+        clearClipBatch();
         Arc* leftArc = mBeachline.getLeftmostArc();
         Arc* rightArc = leftArc->next;
         while (!mBeachline.isNil(rightArc))
         {
-            // Bound the edge
-            Vector2 direction = (leftArc->site->point - rightArc->site->point).getOrthogonal();
-            Vector2 origin = (leftArc->site->point + rightArc->site->point) * 0.5f;
-            // Line-box intersection
-            Box::Intersection intersection = box.getFirstIntersection(origin, direction);
+            mClipBatch.origins.pushBack((leftArc->site->point + rightArc->site->point) * 0.5f);
+            mClipBatch.directions.pushBack((leftArc->site->point - rightArc->site->point).getOrthogonal());
+            leftArc = rightArc;
+            rightArc = rightArc->next;
+        }
+        box.getFirstIntersections(mClipBatch.origins, mClipBatch.directions, mClipBatch.intersections);
+        // Bound the edges
+        leftArc = mBeachline.getLeftmostArc();
+        rightArc = leftArc->next;
+        for (const typename Box::Intersection& intersection : mClipBatch.intersections)
+        {
             // Create a new vertex and ends the half edges
-            VoronoiDiagram::Vertex* vertex = mDiagram.createVertex(intersection.point);
+            Vertex* vertex = mDiagram.createVertex(intersection.point);
             setDestination(leftArc, rightArc, vertex);
-            // Initialize pointers
-            if (vertices.find(leftArc->site->index) == vertices.end()) 
-                vertices[leftArc->site->index].fill(nullptr); 
-            if (vertices.find(rightArc->site->index) == vertices.end()) 
-                vertices[rightArc->site->index].fill(nullptr); 
             // Store the vertex on the boundaries
-            linkedVertices.emplace_back(LinkedVertex{nullptr, vertex, leftArc->rightHalfEdge});
-            vertices[leftArc->site->index][2 * static_cast<int>(intersection.side) + 1] = &linkedVertices.back();
-            linkedVertices.emplace_back(LinkedVertex{rightArc->leftHalfEdge, vertex, nullptr});
-            vertices[rightArc->site->index][2 * static_cast<int>(intersection.side)] = &linkedVertices.back();
+            addLinkedVertex(box, leftArc->site->index, intersection.side, true, LinkedVertex{nullptr, vertex, leftArc->rightHalfEdge});
+            addLinkedVertex(box, rightArc->site->index, intersection.side, false, LinkedVertex{rightArc->leftHalfEdge, vertex, nullptr});
             // Next edge
             leftArc = rightArc;
             rightArc = rightArc->next;
         }
     }
+    // Bound the top of the vertical edges between the sites of the first line
+    for (HalfEdge* halfEdge : mVerticalHalfEdges)
+    {
+        HalfEdge* twin = halfEdge->twin;
+        std::size_t left = halfEdge->incidentFace->site->index;
+        std::size_t right = twin->incidentFace->site->index;
+        Scalar x = Scalar(0.5) * (mDiagram.getSite(left)->point.x + mDiagram.getSite(right)->point.x);
+        Vertex* vertex = mDiagram.createVertex(Vector2(x, box.top));
+        halfEdge->destination = vertex;
+        twin->origin = vertex;
+        // Store the vertex on the boundaries
+        addLinkedVertex(box, left, Box::Side::TOP, false, LinkedVertex{halfEdge, vertex, nullptr});
+        addLinkedVertex(box, right, Box::Side::TOP, true, LinkedVertex{nullptr, vertex, twin});
+    }
+    return linkBorderCells(box); // TO DO: detect the other errors
+}
+
+template<typename B, typename Q>
+bool BasicFortuneAlgorithm<B, Q>::finalize(Box box)
+{
+    bool valid = true;
+    resetBorderCells();
+    clearClipBatch();
+    // Collect the edges to clip, each edge once from the half edge of the site with the smallest index
+    for (HalfEdge& halfEdge : mDiagram.mHalfEdges)
+    {
+        HalfEdge* twin = halfEdge.twin;
+        std::size_t site = halfEdge.incidentFace->site->index;
+        std::size_t twinSite = twin->incidentFace->site->index;
+        if (twinSite < site)
+            continue;
+        Vertex* origin = halfEdge.origin;
+        Vertex* destination = halfEdge.destination;
+        bool originInside = origin != nullptr && box.contains(origin->point);
+        bool destinationInside = destination != nullptr && box.contains(destination->point);
+        if (originInside && destinationInside)
+            continue;
+        // The edges without origin or destination are on the bisector of the two sites
+        Vector2 start;
+        Vector2 direction;
+        Scalar t0 = -std::numeric_limits<Scalar>::infinity();
+        Scalar t1 = std::numeric_limits<Scalar>::infinity();
+        if (origin != nullptr && destination != nullptr)
+        {
+            start = origin->point;
+            direction = destination->point - start;
+            t0 = 0.0;
+            t1 = 1.0;
+        }
+        else
+        {
+            const Vector2& point = mDiagram.getSite(site)->point;
+            const Vector2& twinPoint = mDiagram.getSite(twinSite)->point;
+            direction = (twinPoint - point).getOrthogonal();
+            if (origin != nullptr)
+            {
+                start = origin->point;
+                t0 = 0.0;
+            }
+            else if (destination != nullptr)
+            {
+                start = destination->point;
+                t1 = 0.0;
+            }
+            else
+                start = (point + twinPoint) * 0.5;
+        }
+        mClipBatch.halfEdges.push_back(&halfEdge);
+        mClipBatch.originsInside.push_back(originInside);
+        mClipBatch.destinationsInside.push_back(destinationInside);
+        mClipBatch.origins.pushBack(start);
+        mClipBatch.directions.pushBack(direction);
+        mClipBatch.t0.push_back(t0);
+        mClipBatch.t1.push_back(t1);
+    }
+    // Clip them at once
+    box.clip(mClipBatch.origins, mClipBatch.directions, mClipBatch.t0, mClipBatch.sides0, mClipBatch.t1, mClipBatch.sides1,
+        mClipBatch.valid);
+    for (std::size_t i = 0; i < mClipBatch.halfEdges.size(); ++i)
+    {
+        HalfEdge* halfEdge = mClipBatch.halfEdges[i];
+        HalfEdge* twin = halfEdge->twin;
+        std::size_t site = halfEdge->incidentFace->site->index;
+        std::size_t twinSite = twin->incidentFace->site->index;
+        Vertex* origin = halfEdge->origin;
+        Vertex* destination = halfEdge->destination;
+        bool originInside = mClipBatch.originsInside[i];
+        bool destinationInside = mClipBatch.destinationsInside[i];
+        if (!mClipBatch.valid[i])
+        {
+            // An end inside the box is then on one of its sides, the edge leaves the box there
+            if (originInside)
+                mClipBatch.t1[i] = mClipBatch.t0[i];
+            else if (destinationInside)
+                mClipBatch.t0[i] = mClipBatch.t1[i];
+            // The edges with both ends outside the box are removed
+            else
+            {
+                if (origin != nullptr)
+                    mDiagram.removeVertex(origin);
+                if (destination != nullptr)
+                    mDiagram.removeVertex(destination);
+                mDiagram.removeHalfEdge(halfEdge);
+                mDiagram.removeHalfEdge(twin);
+                // The faces are either closed by border half edges or completely outside the box
+                halfEdge->incidentFace->outerComponent = nullptr;
+                twin->incidentFace->outerComponent = nullptr;
+                continue;
+            }
+        }
+        // Move the ends outside the box on its sides
+        Vector2 start(mClipBatch.origins.x[i], mClipBatch.origins.y[i]);
+        Vector2 direction(mClipBatch.directions.x[i], mClipBatch.directions.y[i]);
+        if (!originInside)
+        {
+            if (origin != nullptr)
+                mDiagram.removeVertex(origin);
+            Vertex* vertex = mDiagram.createVertex(start + mClipBatch.t0[i] * direction);
+            halfEdge->origin = vertex;
+            twin->destination = vertex;
+            addLinkedVertex(box, site, mClipBatch.sides0[i], true, LinkedVertex{nullptr, vertex, halfEdge});
+            addLinkedVertex(box, twinSite, mClipBatch.sides0[i], false, LinkedVertex{twin, vertex, nullptr});
+        }
+        if (!destinationInside)
+        {
+            if (destination != nullptr)
+                mDiagram.removeVertex(destination);
+            Vertex* vertex = mDiagram.createVertex(start + mClipBatch.t1[i] * direction);
+            halfEdge->destination = vertex;
+            twin->origin = vertex;
+            addLinkedVertex(box, site, mClipBatch.sides1[i], false, LinkedVertex{halfEdge, vertex, nullptr});
+            addLinkedVertex(box, twinSite, mClipBatch.sides1[i], true, LinkedVertex{nullptr, vertex, twin});
+        }
+    }
+    // The border half edges become the outer components of the border cells
+    for (const BorderCell& cell : mBorderCells)
+        mDiagram.getFace(cell.site)->outerComponent = nullptr;
+    valid = linkBorderCells(box) && valid;
+    mDiagram.compact();
+    return valid;
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::resetBorderCells()
+{
+    // Only the slots of the border cells are used and they are cleared at the end
+    mLinkedVertices.clear();
+    mBorderCells.clear();
+    if (mBorderCellIndices.size() < mDiagram.getNbSites())
+        mBorderCellIndices.resize(mDiagram.getNbSites(), NO_INDEX);
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::clearClipBatch()
+{
+    mClipBatch.halfEdges.clear();
+    mClipBatch.originsInside.clear();
+    mClipBatch.destinationsInside.clear();
+    mClipBatch.origins.clear();
+    mClipBatch.directions.clear();
+    mClipBatch.t0.clear();
+    mClipBatch.t1.clear();
+}
+
+template<typename B, typename Q>
+bool BasicFortuneAlgorithm<B, Q>::linkBorderCells(Box box)
+{
+    bool valid = true;
     // Add corners
-    for (auto& kv : vertices)
+    for (BorderCell& cell : mBorderCells)
     {
-        auto& cellVertices = kv.second;
+        auto& cellVertices = cell.vertices;
         // We check twice the first side to be sure that all necessary corners are added
         for (std::size_t i = 0; i < 5; ++i)
         {
             std::size_t side = i % 4;
             std::size_t nextSide = (side + 1) % 4;
             // Add first corner
-            if (cellVertices[2 * side] == nullptr && cellVertices[2 * side + 1] != nullptr)
+            if (cellVertices[2 * side] == NO_INDEX && cellVertices[2 * side + 1] != NO_INDEX)
             {
                 std::size_t prevSide = (side + 3) % 4;
-                VoronoiDiagram::Vertex* corner = mDiagram.createCorner(box, static_cast<Box::Side>(side));
-                linkedVertices.emplace_back(LinkedVertex{nullptr, corner, nullptr});
-                cellVertices[2 * prevSide + 1] = &linkedVertices.back();
-                cellVertices[2 * side] = &linkedVertices.back();
+                Vertex* corner = mDiagram.createCorner(box, static_cast<typename Box::Side>(side));
+                mLinkedVertices.push_back(LinkedVertex{nullptr, corner, nullptr});
+                cellVertices[2 * prevSide + 1] = static_cast<std::uint32_t>(mLinkedVertices.size() - 1);
+                cellVertices[2 * side] = static_cast<std::uint32_t>(mLinkedVertices.size() - 1);
             }
             // Add second corner
-            else if (cellVertices[2 * side] != nullptr && cellVertices[2 * side + 1] == nullptr)
+            else if (cellVertices[2 * side] != NO_INDEX && cellVertices[2 * side + 1] == NO_INDEX)
             {
-                VoronoiDiagram::Vertex* corner = mDiagram.createCorner(box, static_cast<Box::Side>(nextSide));
-                linkedVertices.emplace_back(LinkedVertex{nullptr, corner, nullptr});
-                cellVertices[2 * side + 1] = &linkedVertices.back();
-                cellVertices[2 * nextSide] = &linkedVertices.back();
+                Vertex* corner = mDiagram.createCorner(box, static_cast<typename Box::Side>(nextSide));
+                mLinkedVertices.push_back(LinkedVertex{nullptr, corner, nullptr});
+                cellVertices[2 * side + 1] = static_cast<std::uint32_t>(mLinkedVertices.size() - 1);
+                cellVertices[2 * nextSide] = static_cast<std::uint32_t>(mLinkedVertices.size() - 1);
             }
         }
     }
     // Join the half edges
-    for (auto& kv : vertices)
+    for (const BorderCell& cell : mBorderCells)
     {
-        std::size_t i = kv.first;
-        auto& cellVertices = kv.second;
         for (std::size_t side = 0; side < 4; ++side)
         {
-            if (cellVertices[2 * side] != nullptr)
+            std::uint32_t startIndex = cell.vertices[2 * side];
+            std::uint32_t endIndex = cell.vertices[2 * side + 1];
+            if (startIndex == NO_INDEX && endIndex == NO_INDEX)
+                continue;
+            // Rounding errors may leave a side with only one of its ends, the cell can not be closed
+            if (startIndex == NO_INDEX || endIndex == NO_INDEX)
             {
-                // Link vertices 
-                VoronoiDiagram::HalfEdge* halfEdge = mDiagram.createHalfEdge(mDiagram.getFace(i));
-                halfEdge->origin = cellVertices[2 * side]->vertex;
-                halfEdge->destination = cellVertices[2 * side + 1]->vertex;
-                cellVertices[2 * side]->nextHalfEdge = halfEdge;
-                halfEdge->prev = cellVertices[2 * side]->prevHalfEdge;
-                if (cellVertices[2 * side]->prevHalfEdge != nullptr)
-                    cellVertices[2 * side]->prevHalfEdge->next = halfEdge;
-                cellVertices[2 * side + 1]->prevHalfEdge = halfEdge;
-                halfEdge->next = cellVertices[2 * side + 1]->nextHalfEdge;
-                if (cellVertices[2 * side + 1]->nextHalfEdge != nullptr)
-                    cellVertices[2 * side + 1]->nextHalfEdge->prev = halfEdge;
+                valid = false;
+                continue;
             }
+            LinkedVertex& start = mLinkedVertices[startIndex];
+            LinkedVertex& end = mLinkedVertices[endIndex];
+            // Link vertices
+            HalfEdge* halfEdge = mDiagram.createHalfEdge(mDiagram.getFace(cell.site));
+            halfEdge->origin = start.vertex;
+            halfEdge->destination = end.vertex;
+            start.nextHalfEdge = halfEdge;
+            halfEdge->prev = start.prevHalfEdge;
+            if (start.prevHalfEdge != nullptr)
+                start.prevHalfEdge->next = halfEdge;
+            end.prevHalfEdge = halfEdge;
+            halfEdge->next = end.nextHalfEdge;
+            if (end.nextHalfEdge != nullptr)
+                end.nextHalfEdge->prev = halfEdge;
+        }
+    }
+    // Clear the slots
+    for (const BorderCell& cell : mBorderCells)
+        mBorderCellIndices[cell.site] = NO_INDEX;
+    return valid;
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::addLinkedVertex(Box box, std::size_t site, typename Box::Side side, bool isEnd,
+    LinkedVertex linkedVertex)
+{
+    // A vertex on a corner is the end of a side for one of the cells and the start of the next side for the other one
+    side = box.getBorderSide(linkedVertex.vertex->point, side, isEnd);
+    std::uint32_t& i = mBorderCellIndices[site];
+    if (i == NO_INDEX)
+    {
+        i = static_cast<std::uint32_t>(mBorderCells.size());
+        BorderCell cell;
+        cell.site = site;
+        cell.vertices.fill(NO_INDEX);
+        mBorderCells.push_back(cell);
+    }
+    mLinkedVertices.push_back(linkedVertex);
+    mBorderCells[i].vertices[2 * static_cast<int>(side) + (isEnd ? 1 : 0)] = static_cast<std::uint32_t>(mLinkedVertices.size() - 1);
+}
+
+// Streaming
+
+template<typename B, typename Q>
+bool BasicFortuneAlgorithm<B, Q>::emitCell(std::size_t site)
+{
+    // Retrieve the cycle
+    typename VoronoiDiagram::Face* face = mDiagram.getFace(site);
+    HalfEdge* start = face->outerComponent;
+    mCellHalfEdges.clear();
+    for (HalfEdge* halfEdge = start; halfEdge != nullptr; halfEdge = halfEdge->next)
+    {
+        if (halfEdge->origin == nullptr)
+            return false;
+        mCellHalfEdges.push_back(halfEdge);
+        if (halfEdge->next == start)
+            break;
+    }
+    if (start != nullptr && mCellHalfEdges.back()->next != start)
+        return false;
+    // Clip it
+    mCell.site = site;
+    mCell.vertices.clear();
+    bool inside = true;
+    for (const HalfEdge* halfEdge : mCellHalfEdges)
+    {
+        mCell.vertices.push_back(halfEdge->origin->point);
+        inside = inside && mStreamBox.contains(halfEdge->origin->point);
+    }
+    if (!inside)
+        mStreamBox.clipPolygon(mCell.vertices, mClipBuffer);
+    (*mCellCallback)(mCell);
+    mNbSiteArcs[site] = EMITTED;
+    face->outerComponent = nullptr;
+    return true;
+}
+
+template<typename B, typename Q>
+void BasicFortuneAlgorithm<B, Q>::recycleCell()
+{
+    // The edges are recycled with the second of their cells, the vertices with the third
+    for (HalfEdge* halfEdge : mCellHalfEdges)
+    {
+        Vertex* origin = halfEdge->origin;
+        if (--mVertexReferences[origin->index] == 0)
+            mDiagram.recycleVertex(origin);
+        HalfEdge* twin = halfEdge->twin;
+        if (mNbSiteArcs[twin->incidentFace->site->index] == EMITTED)
+        {
+            mDiagram.recycleHalfEdge(halfEdge);
+            mDiagram.recycleHalfEdge(twin);
         }
     }
-    return true; // TO DO: detect errors
 }
 
+template class BasicFortuneAlgorithm<Beachline, EventQueue>;
+template class BasicFortuneAlgorithm<Beachline, HeapEventQueue>;
+template class BasicFortuneAlgorithm<BTreeBeachline, EventQueue>;
+template class BasicFortuneAlgorithm<BTreeBeachline, HeapEventQueue>;
+template class BasicFortuneAlgorithm<BasicBeachline<float>, BasicEventQueue<float>>;
+template class BasicFortuneAlgorithm<BasicBTreeBeachline<float>, BasicEventQueue<float>>;
+template class BasicFortuneAlgorithm<BasicBeachline<long double>, BasicEventQueue<long double>>;
+template class BasicFortuneAlgorithm<BasicBTreeBeachline<long double>, BasicEventQueue<long double>>;
@@ -17,62 +17,246 @@
 
 #pragma once
 
+// STL
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
 // My includes
-#include "PriorityQueue.h"
+#include "EventQueue.h"
+#include "HeapEventQueue.h"
 #include "VoronoiDiagram.h"
 #include "Beachline.h"
+#include "BTreeBeachline.h"
+#include "RadixSort.h"
+#include "Statistics.h"
 
-class Arc;
-class Event;
+// The beachline is a red-black tree unless FORTUNE_BTREE_BEACHLINE is defined
+#ifdef FORTUNE_BTREE_BEACHLINE
+template<typename T>
+using BasicDefaultBeachline = BasicBTreeBeachline<T>;
+#else
+template<typename T>
+using BasicDefaultBeachline = BasicBeachline<T>;
+#endif
+using DefaultBeachline = BasicDefaultBeachline<double>;
 
-class FortuneAlgorithm
+// Types shared by all the instantiations of BasicFortuneAlgorithm
+class FortuneAlgorithmBase
 {
 public:
-    
-    FortuneAlgorithm(std::vector<Vector2> points);
-    ~FortuneAlgorithm();
+    // HEAP: all the site events are pushed in the event queue
+    // SORTED: the sites are sorted once and merged with a queue containing only circle events
+    enum class SiteEventMode{HEAP, SORTED};
+    // ROOT: the arc above each site is searched from the root of the beachline
+    // HINT: the search starts from the arc of the previous site, faster if the sites are spatially coherent
+    enum class LocationMode{ROOT, HINT};
+    // FLOATING: the predicates are evaluated with the scalar type, near-degenerate inputs may give invalid diagrams
+    // INTEGER: the sites must have integer coordinates in the range of std::int32_t, the orientations of the triplets,
+    // the positions relative to the breakpoints and the order of the circle events relative to the site events are
+    // exact and the circle events of converging triplets are never rejected, see IntegerPredicates.h
+    // The coincident sites are skipped, the diagrams given by bound, intersect, finalize and stream are then valid
+    enum class PredicateMode{FLOATING, INTEGER};
 
-    void construct();
+    struct Timings
+    {
+        std::chrono::nanoseconds initialization; // Filling the event queue or sorting the sites
+        std::chrono::nanoseconds sweep;
+    };
+};
+
+// B is the beachline, it must provide the interface of Beachline:
+// - Scalar, the type of the coordinates
+// - reset, createArc, deleteArc
+// - isEmpty, isNil, setRoot, getLeftmostArc, setIntegerSites
+// - locateArcAbove(point, l) and locateArcAbove(point, l, hint), insertBefore, insertAfter, replace, remove
+// - getStatistics if FORTUNE_STATISTICS is defined
+// The arcs must be linked with prev and next, and created with event set to EventQueue::INVALID_HANDLE
+// Q is the event queue, it must provide the interface of EventQueue with the same scalar and handles:
+// - Scalar
+// - isEmpty, getSize, getTopY (the greatest y)
+// - reserve, clear, push(y, event) returning a handle, pop, remove(handle)
+// The member functions are defined in FortuneAlgorithm.cpp which instantiates all the combinations of
+// Beachline and BTreeBeachline with EventQueue and HeapEventQueue, and the float and long double versions
+// of both beachlines with EventQueue
+template<typename B, typename Q>
+class BasicFortuneAlgorithm : public FortuneAlgorithmBase
+{
+public:
+    using Scalar = typename B::Scalar;
+    using Vector2 = BasicVector2<Scalar>;
+    using Vector2Array = BasicVector2Array<Scalar>;
+    using Box = BasicBox<Scalar>;
+    using PointView = BasicPointView<Scalar>;
+    using VoronoiDiagram = BasicVoronoiDiagram<Scalar>;
+    using Arc = BasicArc<Scalar>;
+    using Event = BasicEvent<Scalar>;
+
+    // Cell given by a streaming construction, its vertices are clipped by the box
+    struct Cell
+    {
+        std::size_t site;
+        std::vector<Vector2> vertices; // Empty if the cell is outside the box or if the site is a duplicate
+    };
+    using CellCallback = std::function<void(const Cell&)>;
+
+    static_assert(std::is_same<typename Q::Scalar, Scalar>::value, "The beachline and the queue use the same scalar");
+    static_assert(std::is_same<typename Q::Handle, typename BasicEventQueue<Scalar>::Handle>::value,
+        "The handles are stored in the arcs");
+
+    // The coordinates are copied in the sites of the diagram, the points are not used afterwards
+    // If several sites have the same point, only the first one processed has a cell, the faces of the others are empty
+    BasicFortuneAlgorithm(PointView points);
+    ~BasicFortuneAlgorithm();
+
+    // Start over with new points, the memory already allocated is kept
+    void reset(PointView points);
+    // Same but also reuse the memory of a diagram previously returned by getDiagram
+    void reset(PointView points, VoronoiDiagram diagram);
+
+    void construct(SiteEventMode mode = SiteEventMode::HEAP, LocationMode locationMode = LocationMode::ROOT,
+        PredicateMode predicateMode = PredicateMode::FLOATING);
     bool bound(Box box);
+    // Bound and intersect with the box in a single pass, replaces bound with a bigger box then VoronoiDiagram::intersect
+    // Like VoronoiDiagram::intersect, it compacts the diagram and invalidates the pointers to its vertices and half edges
+    bool finalize(Box box);
+    // Streaming construction, each cell is given to callback clipped by the box as soon as it can no longer change,
+    // that is once the site has no arc left in the beachline, the cells still in the beachline are given at the end
+    // The vertices and half edges of the given cells are recycled so the memory used by the cells is proportional
+    // to the size of the beachline, SORTED also keeps the event queue small
+    // Afterwards the diagram only contains the sites, returns false if a cell can not be closed, it is given empty
+    bool stream(Box box, const CellCallback& callback, SiteEventMode mode = SiteEventMode::HEAP,
+        LocationMode locationMode = LocationMode::ROOT, PredicateMode predicateMode = PredicateMode::FLOATING);
 
     VoronoiDiagram getDiagram();
+    const B& getBeachline() const;
+    const Timings& getTimings() const;
+    std::size_t getNbProcessedEvents() const; // Site and circle events processed by the last construction
+    // Only collected if FORTUNE_STATISTICS is defined
+    const Statistics& getStatistics() const;
 
 private:
+    using Site = typename VoronoiDiagram::Site;
+    using Vertex = typename VoronoiDiagram::Vertex;
+    using HalfEdge = typename VoronoiDiagram::HalfEdge;
+
+    struct LinkedVertex
+    {
+        HalfEdge* prevHalfEdge;
+        Vertex* vertex;
+        HalfEdge* nextHalfEdge;
+    };
+
+    // Vertices on the sides of the box of a cell which is not closed
+    // 2 * side is the start of the border on this side and 2 * side + 1 its end
+    struct BorderCell
+    {
+        std::size_t site;
+        std::array<std::uint32_t, 8> vertices; // Indices in mLinkedVertices
+    };
+
+    // Edges clipped at once by bound and finalize
+    struct ClipBatch
+    {
+        std::vector<HalfEdge*> halfEdges;
+        std::vector<char> originsInside;
+        std::vector<char> destinationsInside;
+        Vector2Array origins;
+        Vector2Array directions;
+        std::vector<Scalar> t0;
+        std::vector<typename Box::Side> sides0;
+        std::vector<Scalar> t1;
+        std::vector<typename Box::Side> sides1;
+        std::vector<char> valid;
+        std::vector<typename Box::Intersection> intersections;
+    };
+
+    static constexpr std::uint32_t NO_INDEX = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t EMITTED = std::numeric_limits<std::uint32_t>::max();
+
     VoronoiDiagram mDiagram;
-    Beachline mBeachline;
-    PriorityQueue<Event> mEvents;
-    double mBeachlineY;
+    B mBeachline;
+    Q mEvents;
+    Scalar mBeachlineY;
+    LocationMode mLocationMode;
+    PredicateMode mPredicateMode;
+    Arc* mHint; // Arc of the last site, nullptr if there is none
+    Timings mTimings;
+    std::size_t mNbProcessedEvents;
+    Statistics mStatistics;
+    // Sorting
+    std::vector<std::uint64_t> mSiteKeys;
+    std::vector<std::uint32_t> mSiteOrder;
+    RadixSortBuffers mSortBuffers;
+    // Half edges between the sites of the first line, they are unbounded at the top
+    Scalar mFirstLineY;
+    std::vector<HalfEdge*> mVerticalHalfEdges;
+    // Bounding
+    std::vector<LinkedVertex> mLinkedVertices;
+    std::vector<BorderCell> mBorderCells;
+    std::vector<std::uint32_t> mBorderCellIndices; // Index in mBorderCells for each site, NO_INDEX if none
+    ClipBatch mClipBatch;
+    // Streaming
+    const CellCallback* mCellCallback; // nullptr if the construction is not streamed
+    Box mStreamBox;
+    std::size_t mNbCircleEvents;
+    std::vector<std::uint32_t> mNbSiteArcs; // Arcs of each site in the beachline, EMITTED once its cell is given
+    std::vector<std::uint8_t> mVertexReferences; // Cells not given yet around each vertex, indexed by slot
+    std::vector<HalfEdge*> mCellHalfEdges;
+    Cell mCell;
+    std::vector<Vector2> mClipBuffer;
 
     // Algorithm
-    void handleSiteEvent(Event* event);
-    void handleCircleEvent(Event* event);
+    void sweep(SiteEventMode mode, LocationMode locationMode, PredicateMode predicateMode);
+    void initializeHeap();
+    void sweepHeap();
+    void sortSites();
+    void sweepSorted();
+    void sortFirstLine(std::vector<std::uint32_t>::iterator begin, std::vector<std::uint32_t>::iterator end);
+    void handleSiteEvent(const Event& event);
+    void handleCircleEvent(const Event& event);
 
     // Arcs
-    Arc* breakArc(Arc* arc, VoronoiDiagram::Site* site);
-    void removeArc(Arc* arc, VoronoiDiagram::Vertex* vertex);
-
-    // Breakpoint
-    bool isMovingRight(const Arc* left, const Arc* right) const;
-    double getInitialX(const Arc* left, const Arc* right, bool movingRight) const;
+    Arc* breakArc(Arc* arc, Site* site);
+    bool isCoincident(const Arc* arc, const Site* site) const; // True if the site or one of its neighbors has the point
+    void removeArc(Arc* arc, Vertex* vertex);
 
     // Edges
     void addEdge(Arc* left, Arc* right);
-    void setOrigin(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex);
-    void setDestination(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex);
-    void setPrevHalfEdge(VoronoiDiagram::HalfEdge* prev, VoronoiDiagram::HalfEdge* next);
+    void setOrigin(Arc* left, Arc* right, Vertex* vertex);
+    void setDestination(Arc* left, Arc* right, Vertex* vertex);
+    void setPrevHalfEdge(HalfEdge* prev, HalfEdge* next);
 
     // Events
-    void addEvent(Arc* left, Arc* middle, Arc* right);
+    void addEvents(Arc* left, Arc* right); // Triplets centered on left and right
+    void addEvent(Arc* left, Arc* middle, Arc* right, Scalar orientation);
     void deleteEvent(Arc* arc);
-    Vector2 computeConvergencePoint(const Vector2& point1, const Vector2& point2, const Vector2& point3, double& y) const;
+    // Only the sign is meaningful with PredicateMode::INTEGER
+    Scalar computeOrientation(const Vector2& point1, const Vector2& point2, const Vector2& point3) const;
+    Vector2 computeConvergencePoint(const Vector2& point1, const Vector2& point2, const Vector2& point3,
+        Scalar orientation, Scalar& y) const;
 
     // Bounding
+    void resetBorderCells();
+    void clearClipBatch();
+    bool linkBorderCells(Box box); // False if a border cell can not be closed
+    void addLinkedVertex(Box box, std::size_t site, typename Box::Side side, bool isEnd, LinkedVertex linkedVertex);
 
-    struct LinkedVertex
-    {
-        VoronoiDiagram::HalfEdge* prevHalfEdge;
-        VoronoiDiagram::Vertex* vertex;
-        VoronoiDiagram::HalfEdge* nextHalfEdge;
-    };
+    // Streaming
+    bool emitCell(std::size_t site); // False if the cell is not closed, it is not given then
+    void recycleCell(); // Elements of the last given cell which are not used by the other cells anymore
 };
 
+extern template class BasicFortuneAlgorithm<Beachline, EventQueue>;
+extern template class BasicFortuneAlgorithm<Beachline, HeapEventQueue>;
+extern template class BasicFortuneAlgorithm<BTreeBeachline, EventQueue>;
+extern template class BasicFortuneAlgorithm<BTreeBeachline, HeapEventQueue>;
+extern template class BasicFortuneAlgorithm<BasicBeachline<float>, BasicEventQueue<float>>;
+extern template class BasicFortuneAlgorithm<BasicBTreeBeachline<float>, BasicEventQueue<float>>;
+extern template class BasicFortuneAlgorithm<BasicBeachline<long double>, BasicEventQueue<long double>>;
+extern template class BasicFortuneAlgorithm<BasicBTreeBeachline<long double>, BasicEventQueue<long double>>;
+
+using FortuneAlgorithm = BasicFortuneAlgorithm<DefaultBeachline, EventQueue>;
@@ -0,0 +1,259 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrozenDiagram.h"
+// STL
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr FrozenDiagram::Index FrozenDiagram::INVALID_INDEX;
+
+namespace
+{
+
+// The arrays are mapped as is, so their layout must not depend on the compiler
+static_assert(sizeof(Vector2) == 2 * sizeof(double) && std::is_trivially_copyable<Vector2>::value,
+    "Vector2 must be two packed doubles");
+static_assert(sizeof(FrozenDiagram::HalfEdge) == 4 * sizeof(FrozenDiagram::Index) &&
+    std::is_trivially_copyable<FrozenDiagram::HalfEdge>::value, "HalfEdge must be four packed indices");
+
+constexpr char MAGIC[8] = {'F', 'R', 'O', 'Z', 'E', 'N', 'V', 'D'};
+// Increment when the layout of the file changes
+constexpr std::uint32_t FORMAT_VERSION = 1;
+// Read as another value on a machine with another byte order
+constexpr std::uint32_t ENDIANNESS_MARK = 0x01020304;
+// Each array starts on a cache line
+constexpr std::uint64_t ARRAY_ALIGNMENT = 64;
+
+struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endiannessMark;
+    std::uint64_t nbSites;
+    std::uint64_t nbVertices;
+    std::uint64_t nbHalfEdges;
+    // Offsets of the arrays from the start of the file
+    std::uint64_t sitePointsOffset;
+    std::uint64_t outerComponentsOffset;
+    std::uint64_t vertexPointsOffset;
+    std::uint64_t halfEdgesOffset;
+};
+
+// Storage of a diagram built in memory
+struct Arrays
+{
+    std::vector<Vector2> sitePoints;
+    std::vector<FrozenDiagram::Index> outerComponents;
+    std::vector<Vector2> vertexPoints;
+    std::vector<FrozenDiagram::HalfEdge> halfEdges;
+};
+
+std::uint64_t alignOffset(std::uint64_t offset)
+{
+    return (offset + ARRAY_ALIGNMENT - 1) / ARRAY_ALIGNMENT * ARRAY_ALIGNMENT;
+}
+
+bool isArrayInFile(std::uint64_t offset, std::uint64_t nbElements, std::size_t elementSize, std::size_t fileSize)
+{
+    return offset % ARRAY_ALIGNMENT == 0 && offset <= fileSize && nbElements <= (fileSize - offset) / elementSize;
+}
+
+}
+
+FrozenDiagram FrozenDiagram::load(const std::string& path)
+{
+    int file = open(path.c_str(), O_RDONLY);
+    if (file == -1)
+        throw std::runtime_error("Impossible to open " + path);
+    struct stat status;
+    if (fstat(file, &status) == -1 || static_cast<std::size_t>(status.st_size) < sizeof(FileHeader))
+    {
+        close(file);
+        throw std::runtime_error(path + " is not a frozen diagram");
+    }
+    auto size = static_cast<std::size_t>(status.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+    // The mapping remains valid after the file is closed
+    close(file);
+    if (address == MAP_FAILED)
+        throw std::runtime_error("Impossible to map " + path);
+    auto storage = std::shared_ptr<const void>(address, [size](const void* mapping)
+    {
+        munmap(const_cast<void*>(mapping), size);
+    });
+    // Check the header, the indices in the arrays are trusted
+    const auto* bytes = static_cast<const char*>(address);
+    FileHeader header;
+    std::memcpy(&header, bytes, sizeof(FileHeader));
+    if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0)
+        throw std::runtime_error(path + " is not a frozen diagram");
+    if (header.endiannessMark != ENDIANNESS_MARK)
+        throw std::runtime_error(path + " was written on a machine with another byte order");
+    if (header.version != FORMAT_VERSION)
+        throw std::runtime_error(path + " has version " + std::to_string(header.version) + " instead of " +
+            std::to_string(FORMAT_VERSION));
+    if (!isArrayInFile(header.sitePointsOffset, header.nbSites, sizeof(Vector2), size) ||
+        !isArrayInFile(header.outerComponentsOffset, header.nbSites, sizeof(Index), size) ||
+        !isArrayInFile(header.vertexPointsOffset, header.nbVertices, sizeof(Vector2), size) ||
+        !isArrayInFile(header.halfEdgesOffset, header.nbHalfEdges, sizeof(HalfEdge), size))
+        throw std::runtime_error(path + " is truncated");
+    // Point the arrays into the mapping
+    FrozenDiagram diagram;
+    diagram.mSitePoints = reinterpret_cast<const Vector2*>(bytes + header.sitePointsOffset);
+    diagram.mOuterComponents = reinterpret_cast<const Index*>(bytes + header.outerComponentsOffset);
+    diagram.mVertexPoints = reinterpret_cast<const Vector2*>(bytes + header.vertexPointsOffset);
+    diagram.mHalfEdges = reinterpret_cast<const HalfEdge*>(bytes + header.halfEdgesOffset);
+    diagram.mNbSites = header.nbSites;
+    diagram.mNbVertices = header.nbVertices;
+    diagram.mNbHalfEdges = header.nbHalfEdges;
+    diagram.mMemoryUsage = size;
+    diagram.mStorage = std::move(storage);
+    return diagram;
+}
+
+std::size_t FrozenDiagram::getNbSites() const
+{
+    return mNbSites;
+}
+
+Vector2 FrozenDiagram::getSitePoint(Index site) const
+{
+    return mSitePoints[site];
+}
+
+FrozenDiagram::Index FrozenDiagram::getOuterComponent(Index face) const
+{
+    return mOuterComponents[face];
+}
+
+std::size_t FrozenDiagram::getNbVertices() const
+{
+    return mNbVertices;
+}
+
+Vector2 FrozenDiagram::getVertexPoint(Index vertex) const
+{
+    return mVertexPoints[vertex];
+}
+
+std::size_t FrozenDiagram::getNbHalfEdges() const
+{
+    return mNbHalfEdges;
+}
+
+const FrozenDiagram::HalfEdge& FrozenDiagram::getHalfEdge(Index halfEdge) const
+{
+    return mHalfEdges[halfEdge];
+}
+
+FrozenDiagram::Index FrozenDiagram::getOrigin(Index halfEdge) const
+{
+    return mHalfEdges[halfEdge].origin;
+}
+
+FrozenDiagram::Index FrozenDiagram::getDestination(Index halfEdge) const
+{
+    return mHalfEdges[getTwin(halfEdge)].origin;
+}
+
+FrozenDiagram::Index FrozenDiagram::getIncidentFace(Index halfEdge) const
+{
+    return mHalfEdges[halfEdge].incidentFace;
+}
+
+FrozenDiagram::Index FrozenDiagram::getPrev(Index halfEdge) const
+{
+    return mHalfEdges[halfEdge].prev;
+}
+
+FrozenDiagram::Index FrozenDiagram::getNext(Index halfEdge) const
+{
+    return mHalfEdges[halfEdge].next;
+}
+
+void FrozenDiagram::save(const std::string& path) const
+{
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.endiannessMark = ENDIANNESS_MARK;
+    header.nbSites = mNbSites;
+    header.nbVertices = mNbVertices;
+    header.nbHalfEdges = mNbHalfEdges;
+    // Place the arrays after the header
+    std::uint64_t end = sizeof(FileHeader);
+    auto placeArray = [&end](std::size_t nbBytes)
+    {
+        std::uint64_t offset = alignOffset(end);
+        end = offset + nbBytes;
+        return offset;
+    };
+    header.sitePointsOffset = placeArray(mNbSites * sizeof(Vector2));
+    header.outerComponentsOffset = placeArray(mNbSites * sizeof(Index));
+    header.vertexPointsOffset = placeArray(mNbVertices * sizeof(Vector2));
+    header.halfEdgesOffset = placeArray(mNbHalfEdges * sizeof(HalfEdge));
+    // Write them
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    std::uint64_t position = sizeof(FileHeader);
+    auto writeArray = [&file, &position](std::uint64_t offset, const void* data, std::size_t nbBytes)
+    {
+        static const char padding[ARRAY_ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(offset - position));
+        if (nbBytes > 0)
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(nbBytes));
+        position = offset + nbBytes;
+    };
+    writeArray(header.sitePointsOffset, mSitePoints, mNbSites * sizeof(Vector2));
+    writeArray(header.outerComponentsOffset, mOuterComponents, mNbSites * sizeof(Index));
+    writeArray(header.vertexPointsOffset, mVertexPoints, mNbVertices * sizeof(Vector2));
+    writeArray(header.halfEdgesOffset, mHalfEdges, mNbHalfEdges * sizeof(HalfEdge));
+    file.close();
+    if (!file)
+        throw std::runtime_error("Impossible to write " + path);
+}
+
+std::size_t FrozenDiagram::getMemoryUsage() const
+{
+    return mMemoryUsage;
+}
+
+FrozenDiagram::FrozenDiagram(std::vector<Vector2> sitePoints, std::vector<Index> outerComponents,
+    std::vector<Vector2> vertexPoints, std::vector<HalfEdge> halfEdges)
+{
+    auto arrays = std::make_shared<Arrays>(Arrays{std::move(sitePoints), std::move(outerComponents),
+        std::move(vertexPoints), std::move(halfEdges)});
+    mSitePoints = arrays->sitePoints.data();
+    mOuterComponents = arrays->outerComponents.data();
+    mVertexPoints = arrays->vertexPoints.data();
+    mHalfEdges = arrays->halfEdges.data();
+    mNbSites = arrays->sitePoints.size();
+    mNbVertices = arrays->vertexPoints.size();
+    mNbHalfEdges = arrays->halfEdges.size();
+    mMemoryUsage = arrays->sitePoints.capacity() * sizeof(Vector2) +
+        arrays->outerComponents.capacity() * sizeof(Index) + arrays->vertexPoints.capacity() * sizeof(Vector2) +
+        arrays->halfEdges.capacity() * sizeof(HalfEdge);
+    mStorage = std::move(arrays);
+}
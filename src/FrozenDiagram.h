@@ -0,0 +1,106 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+// My includes
+#include "Vector2.h"
+
+template<typename T>
+class BasicVoronoiDiagram;
+
+// Immutable index-based version of a Voronoi diagram
+// The twins are stored pairwise: the twin of the half edge i is i ^ 1. Half edges
+// on the border of the box get a twin without incident face.
+// Only const accessors are provided so that it can be shared between threads.
+// The arrays are either owned or mapped from a file written by save, copies share them.
+class FrozenDiagram
+{
+public:
+    using Index = std::uint32_t;
+    static constexpr Index INVALID_INDEX = std::numeric_limits<Index>::max();
+
+    struct HalfEdge
+    {
+        Index origin;
+        Index incidentFace;
+        Index prev;
+        Index next;
+    };
+
+    // Map a file written by save, the arrays are used in place without any copy
+    // Throws std::runtime_error if the file can not be mapped or is not in the current format
+    static FrozenDiagram load(const std::string& path);
+
+    FrozenDiagram() = default;
+
+    // Sites and faces
+    std::size_t getNbSites() const;
+    Vector2 getSitePoint(Index site) const;
+    Index getOuterComponent(Index face) const;
+
+    // Vertices
+    std::size_t getNbVertices() const;
+    Vector2 getVertexPoint(Index vertex) const;
+
+    // Half edges
+    std::size_t getNbHalfEdges() const;
+    const HalfEdge& getHalfEdge(Index halfEdge) const;
+    Index getOrigin(Index halfEdge) const;
+    Index getDestination(Index halfEdge) const;
+    Index getIncidentFace(Index halfEdge) const;
+    Index getPrev(Index halfEdge) const;
+    Index getNext(Index halfEdge) const;
+
+    static Index getTwin(Index halfEdge)
+    {
+        return halfEdge ^ 1;
+    }
+
+    // Serialization
+    // The arrays are written with the byte order of the machine after a versioned header
+    // Throws std::runtime_error if the file can not be written
+    void save(const std::string& path) const;
+
+    // Memory
+    std::size_t getMemoryUsage() const; // Size of the mapping for a loaded diagram
+
+private:
+    template<typename T>
+    friend class BasicVoronoiDiagram;
+    friend FrozenDiagram decodeDiagram(std::istream& stream);
+
+    std::shared_ptr<const void> mStorage;
+    const Vector2* mSitePoints = nullptr;
+    const Index* mOuterComponents = nullptr;
+    const Vector2* mVertexPoints = nullptr;
+    const HalfEdge* mHalfEdges = nullptr;
+    std::size_t mNbSites = 0;
+    std::size_t mNbVertices = 0;
+    std::size_t mNbHalfEdges = 0;
+    std::size_t mMemoryUsage = 0;
+
+    FrozenDiagram(std::vector<Vector2> sitePoints, std::vector<Index> outerComponents,
+        std::vector<Vector2> vertexPoints, std::vector<HalfEdge> halfEdges);
+};
@@ -0,0 +1,124 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HeapEventQueue.h"
+// STL
+#include <algorithm>
+
+template<typename T>
+constexpr typename BasicHeapEventQueue<T>::Handle BasicHeapEventQueue<T>::INVALID_HANDLE;
+
+template<typename T>
+BasicHeapEventQueue<T>::BasicHeapEventQueue() : mSize(0)
+{
+
+}
+
+template<typename T>
+bool BasicHeapEventQueue<T>::isEmpty() const
+{
+    return mSize == 0;
+}
+
+template<typename T>
+std::size_t BasicHeapEventQueue<T>::getSize() const
+{
+    return mSize;
+}
+
+template<typename T>
+T BasicHeapEventQueue<T>::getTopY() const
+{
+    return mHeap.front().y;
+}
+
+template<typename T>
+void BasicHeapEventQueue<T>::reserve(std::size_t capacity)
+{
+    mHeap.reserve(capacity);
+    mEvents.reserve(capacity);
+    mRemoved.reserve(capacity);
+}
+
+template<typename T>
+void BasicHeapEventQueue<T>::clear()
+{
+    mHeap.clear();
+    mEvents.clear();
+    mRemoved.clear();
+    mFreeHandles.clear();
+    mSize = 0;
+}
+
+template<typename T>
+typename BasicHeapEventQueue<T>::Handle BasicHeapEventQueue<T>::push(T y, const Event& event)
+{
+    Handle handle;
+    if (!mFreeHandles.empty())
+    {
+        handle = mFreeHandles.back();
+        mFreeHandles.pop_back();
+        mEvents[handle] = event;
+        mRemoved[handle] = false;
+    }
+    else
+    {
+        handle = static_cast<Handle>(mEvents.size());
+        mEvents.push_back(event);
+        mRemoved.push_back(false);
+    }
+    mHeap.push_back(Node{y, handle, event.type == Event::Type::SITE});
+    std::push_heap(mHeap.begin(), mHeap.end());
+    ++mSize;
+    return handle;
+}
+
+template<typename T>
+BasicEvent<T> BasicHeapEventQueue<T>::pop()
+{
+    Handle handle = mHeap.front().handle;
+    Event event = mEvents[handle];
+    std::pop_heap(mHeap.begin(), mHeap.end());
+    mHeap.pop_back();
+    mFreeHandles.push_back(handle);
+    --mSize;
+    discardRemoved();
+    return event;
+}
+
+template<typename T>
+void BasicHeapEventQueue<T>::remove(Handle handle)
+{
+    mRemoved[handle] = true;
+    --mSize;
+    discardRemoved();
+}
+
+template<typename T>
+void BasicHeapEventQueue<T>::discardRemoved()
+{
+    while (!mHeap.empty() && mRemoved[mHeap.front().handle])
+    {
+        mFreeHandles.push_back(mHeap.front().handle);
+        std::pop_heap(mHeap.begin(), mHeap.end());
+        mHeap.pop_back();
+    }
+}
+
+template class BasicHeapEventQueue<float>;
+template class BasicHeapEventQueue<double>;
+template class BasicHeapEventQueue<long double>;
@@ -0,0 +1,83 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+// My includes
+#include "Event.h"
+#include "EventQueue.h"
+
+// Event queue built on the heap algorithms of the standard library
+// The removals are lazy: a removed event stays in the heap until it reaches the top,
+// its handle is only reused once it has been discarded
+template<typename T>
+class BasicHeapEventQueue
+{
+public:
+    using Scalar = T;
+    using Event = BasicEvent<T>;
+    using Handle = typename BasicEventQueue<T>::Handle;
+    static constexpr Handle INVALID_HANDLE = BasicEventQueue<T>::INVALID_HANDLE;
+
+    BasicHeapEventQueue();
+
+    // Accessors
+
+    bool isEmpty() const;
+    std::size_t getSize() const; // Removed events are not counted
+    T getTopY() const;
+
+    // Operations
+
+    void reserve(std::size_t capacity);
+    void clear();
+    Handle push(T y, const Event& event);
+    Event pop();
+    void remove(Handle handle);
+
+private:
+    struct Node
+    {
+        T y;
+        Handle handle;
+        bool isSite;
+
+        // At the same y, the circle events are handled before the site events
+        bool operator<(const Node& node) const
+        {
+            return y < node.y || (y == node.y && isSite && !node.isSite);
+        }
+    };
+
+    std::vector<Node> mHeap;
+    std::vector<Event> mEvents;
+    std::vector<char> mRemoved;
+    std::vector<Handle> mFreeHandles;
+    std::size_t mSize;
+
+    // Remove the removed events from the top of the heap
+    void discardRemoved();
+};
+
+extern template class BasicHeapEventQueue<float>;
+extern template class BasicHeapEventQueue<double>;
+extern template class BasicHeapEventQueue<long double>;
+
+using HeapEventQueue = BasicHeapEventQueue<double>;
@@ -0,0 +1,246 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+// My includes
+#include "Vector2.h"
+#include "Breakpoint.h"
+
+// Predicates for sites with integer coordinates in the range of std::int32_t
+// The differences of coordinates are exact with doubles, the predicates are first evaluated with doubles and the
+// result is returned if it is larger than the bound of the rounding errors, otherwise they are evaluated exactly
+// with 128-bit integers, or 256-bit products for the lowest points of the circles
+
+using Int128 = __int128;
+using UInt128 = unsigned __int128;
+
+// Sign of a * b - c * d, the operands are integers with at most 33 bits
+inline int getSignOfDifferenceOfProducts(double a, double b, double c, double d)
+{
+    double lhs = a * b;
+    double rhs = c * d;
+    double difference = lhs - rhs;
+    double bound = 2.0 * std::numeric_limits<double>::epsilon() * (std::abs(lhs) + std::abs(rhs));
+    if (difference > bound)
+        return 1;
+    if (difference < -bound)
+        return -1;
+    Int128 exactDifference = Int128(static_cast<std::int64_t>(a)) * static_cast<std::int64_t>(b) -
+        Int128(static_cast<std::int64_t>(c)) * static_cast<std::int64_t>(d);
+    return (exactDifference > 0) - (exactDifference < 0);
+}
+
+// Sign of (point1 - point2).getDet(point2 - point3), negative if the triplet turns clockwise
+template<typename T>
+int computeIntegerOrientation(const BasicVector2<T>& point1, const BasicVector2<T>& point2,
+    const BasicVector2<T>& point3)
+{
+    double x2 = static_cast<double>(point2.x);
+    double y2 = static_cast<double>(point2.y);
+    return getSignOfDifferenceOfProducts(static_cast<double>(point1.x) - x2, y2 - static_cast<double>(point3.y),
+        static_cast<double>(point1.y) - y2, x2 - static_cast<double>(point3.x));
+}
+
+// Same as compareWithBreakpoint(x1, y1, x2, y2, x, l) but exact, l must also be an integer
+// With u = x1 - x, e = y1 - l and a, b, c defined the same way, delta - b * b = -4 * a * c so the sign of
+// b - sqrt(delta) only depends on the signs of b, a and c
+template<typename T>
+int compareWithIntegerBreakpoint(T x1, T y1, T x2, T y2, T x, T l)
+{
+    // The degenerate cases only involve the half of the sum of two integers, which is exact with doubles
+    if (y1 == y2 || y1 == l || y2 == l)
+        return compareWithBreakpoint(static_cast<double>(x1), static_cast<double>(y1), static_cast<double>(x2),
+            static_cast<double>(y2), static_cast<double>(x), static_cast<double>(l));
+    double u1 = static_cast<double>(x1) - static_cast<double>(x);
+    double u2 = static_cast<double>(x2) - static_cast<double>(x);
+    double e1 = static_cast<double>(y1) - static_cast<double>(l);
+    double e2 = static_cast<double>(y2) - static_cast<double>(l);
+    double a = e2 - e1;
+    int sign = -1;
+    if (getSignOfDifferenceOfProducts(u2, e1, u1, e2) >= 0)
+    {
+        double c1 = (e1 * e1 + u1 * u1) * e2;
+        double c2 = (e2 * e2 + u2 * u2) * e1;
+        double c = c1 - c2;
+        double bound = 4.0 * std::numeric_limits<double>::epsilon() * (std::abs(c1) + std::abs(c2));
+        int cSign;
+        if (c > bound)
+            cSign = 1;
+        else if (c < -bound)
+            cSign = -1;
+        else
+        {
+            Int128 iu1 = static_cast<std::int64_t>(u1);
+            Int128 iu2 = static_cast<std::int64_t>(u2);
+            Int128 ie1 = static_cast<std::int64_t>(e1);
+            Int128 ie2 = static_cast<std::int64_t>(e2);
+            Int128 exactC = (ie1 * ie1 + iu1 * iu1) * ie2 - (ie2 * ie2 + iu2 * iu2) * ie1;
+            cSign = (exactC > 0) - (exactC < 0);
+        }
+        sign = a > 0.0 ? cSign : -cSign;
+    }
+    return a > 0.0 ? sign : -sign;
+}
+
+template<typename T>
+int compareWithIntegerBreakpoint(const BasicVector2<T>& point1, const BasicVector2<T>& point2, T x, T l)
+{
+    return compareWithIntegerBreakpoint(point1.x, point1.y, point2.x, point2.y, x, l);
+}
+
+// compareWithIntegerBreakpoint if integerSites is true, compareWithBreakpoint otherwise
+template<typename T>
+int compareWithBreakpoint(T x1, T y1, T x2, T y2, T x, T l, bool integerSites)
+{
+    return integerSites ? compareWithIntegerBreakpoint(x1, y1, x2, y2, x, l) :
+        compareWithBreakpoint(x1, y1, x2, y2, x, l);
+}
+
+template<typename T>
+int compareWithBreakpoint(const BasicVector2<T>& point1, const BasicVector2<T>& point2, T x, T l, bool integerSites)
+{
+    return compareWithBreakpoint(point1.x, point1.y, point2.x, point2.y, x, l, integerSites);
+}
+
+// Product of two unsigned 128-bit integers as its high and low halves
+inline std::pair<UInt128, UInt128> multiplyExactly(UInt128 a, UInt128 b)
+{
+    UInt128 mask = ~std::uint64_t(0);
+    UInt128 a0 = a & mask;
+    UInt128 a1 = a >> 64;
+    UInt128 b0 = b & mask;
+    UInt128 b1 = b >> 64;
+    UInt128 low = a0 * b0;
+    UInt128 high = a1 * b1;
+    UInt128 middle = a1 * b0;
+    UInt128 otherMiddle = a0 * b1;
+    middle += otherMiddle;
+    high += UInt128(middle < otherMiddle) << 64;
+    UInt128 shiftedMiddle = middle << 64;
+    low += shiftedMiddle;
+    high += (middle >> 64) + (low < shiftedMiddle);
+    return std::make_pair(high, low);
+}
+
+// Sign of yOffset + (ny - sqrt(nx * nx + ny * ny)) / d with d positive, the squares are compared with 256 bits
+inline int getSignOfCircleBottom(Int128 d, Int128 nx, Int128 ny, Int128 yOffset)
+{
+    Int128 a = yOffset * d + ny;
+    if (a < 0)
+        return -1;
+    std::pair<UInt128, UInt128> lhs = multiplyExactly(a, a);
+    std::pair<UInt128, UInt128> squaredNx = multiplyExactly(nx < 0 ? -nx : nx, nx < 0 ? -nx : nx);
+    std::pair<UInt128, UInt128> squaredNy = multiplyExactly(ny < 0 ? -ny : ny, ny < 0 ? -ny : ny);
+    std::pair<UInt128, UInt128> rhs(squaredNx.first + squaredNy.first, squaredNx.second + squaredNy.second);
+    rhs.first += rhs.second < squaredNx.second;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+// Lowest point of the circle of center (nx, ny) / d through the origin, without cancellation
+template<typename Real>
+Real computeCircleBottom(Real d, Real nx, Real ny)
+{
+    Real r = std::sqrt(nx * nx + ny * ny);
+    // ny - r = -nx * nx / (ny + r)
+    return ny > Real(0) ? -nx * nx / ((ny + r) * d) : (ny - r) / d;
+}
+
+// Center of the circle through three integer points turning clockwise and y of its lowest point
+// The center is point2 + (nx, ny) / d, they are first computed with doubles and exactly if the rounding errors may
+// change the result: if the points are almost collinear, so that d is never 0, or if y is close to an integer
+// y is then rounded to the correct side of the integer, so that it compares with the y of any site like the exact
+// value does, only the comparisons with other circle events depend on rounding
+template<typename T>
+BasicVector2<T> computeIntegerConvergencePoint(const BasicVector2<T>& point1, const BasicVector2<T>& point2,
+    const BasicVector2<T>& point3, T& y)
+{
+    // At least double precision, long double if T is long double, the differences are exact
+    using Real = decltype(T(0) + 0.0);
+    Real epsilon = std::numeric_limits<double>::epsilon();
+    Real x1 = static_cast<Real>(point1.x) - static_cast<Real>(point2.x);
+    Real y1 = static_cast<Real>(point1.y) - static_cast<Real>(point2.y);
+    Real x3 = static_cast<Real>(point3.x) - static_cast<Real>(point2.x);
+    Real y3 = static_cast<Real>(point3.y) - static_cast<Real>(point2.y);
+    Real lhs = x1 * y3;
+    Real rhs = y1 * x3;
+    Real d = Real(2) * (lhs - rhs);
+    Real squaredNorm1 = x1 * x1 + y1 * y1;
+    Real squaredNorm3 = x3 * x3 + y3 * y3;
+    Real nx = squaredNorm1 * y3 - squaredNorm3 * y1;
+    Real ny = squaredNorm3 * x1 - squaredNorm1 * x3;
+    // Bounds of the rounding errors of d, nx and ny, and of the resulting error of the lowest point
+    Real errorD = Real(2) * epsilon * (std::abs(lhs) + std::abs(rhs));
+    Real errorN = Real(4) * epsilon * (std::abs(squaredNorm1 * y3) + std::abs(squaredNorm3 * y1) +
+        std::abs(squaredNorm3 * x1) + std::abs(squaredNorm1 * x3));
+    Real bottom = Real(0);
+    Real bound = std::numeric_limits<Real>::infinity();
+    if (d > Real(8) * errorD)
+    {
+        bottom = computeCircleBottom(d, nx, ny);
+        bound = Real(2) * (Real(3) * errorN + std::abs(bottom) * errorD) / d +
+            Real(16) * epsilon * (std::abs(bottom) + std::abs(static_cast<Real>(point2.y)));
+    }
+    Real approximateY = static_cast<Real>(point2.y) + bottom;
+    // Beyond this range, y is below all the sites
+    Real minY = -Real(std::int64_t(1) << 32);
+    bool isCloseToInteger = false;
+    if (bound < Real(0.25) && approximateY + bound >= minY)
+        isCloseToInteger = std::abs(approximateY - std::round(approximateY)) <= bound;
+    if (bound >= Real(0.25) || isCloseToInteger)
+    {
+        std::int64_t y2 = static_cast<std::int64_t>(point2.y);
+        Int128 ix1 = static_cast<std::int64_t>(x1);
+        Int128 iy1 = static_cast<std::int64_t>(y1);
+        Int128 ix3 = static_cast<std::int64_t>(x3);
+        Int128 iy3 = static_cast<std::int64_t>(y3);
+        Int128 exactSquaredNorm1 = ix1 * ix1 + iy1 * iy1;
+        Int128 exactSquaredNorm3 = ix3 * ix3 + iy3 * iy3;
+        Int128 exactD = 2 * (ix1 * iy3 - iy1 * ix3);
+        Int128 exactNx = exactSquaredNorm1 * iy3 - exactSquaredNorm3 * iy1;
+        Int128 exactNy = exactSquaredNorm3 * ix1 - exactSquaredNorm1 * ix3;
+        d = static_cast<Real>(exactD);
+        nx = static_cast<Real>(exactNx);
+        ny = static_cast<Real>(exactNy);
+        bottom = computeCircleBottom(d, nx, ny);
+        approximateY = static_cast<Real>(point2.y) + bottom;
+        y = static_cast<T>(approximateY);
+        // The error is now only the one of computeCircleBottom, far below 0.5 in the range of the sites
+        if (approximateY >= minY)
+        {
+            std::int64_t n = std::llround(approximateY);
+            T integer = static_cast<T>(n);
+            int sign = getSignOfCircleBottom(exactD, exactNx, exactNy, y2 - n);
+            if (sign == 0)
+                y = integer;
+            else if (sign > 0)
+                y = std::max(y, std::nextafter(integer, std::numeric_limits<T>::infinity()));
+            else
+                y = std::min(y, std::nextafter(integer, -std::numeric_limits<T>::infinity()));
+        }
+    }
+    else
+        y = static_cast<T>(approximateY);
+    return BasicVector2<T>(static_cast<T>(static_cast<Real>(point2.x) + nx / d),
+        static_cast<T>(static_cast<Real>(point2.y) + ny / d));
+}
@@ -0,0 +1,126 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+// Slab allocator with an intrusive free list
+// Slabs grow geometrically and are only released when the pool is destroyed
+template<typename T>
+class MemoryPool
+{
+    static_assert(std::is_trivially_destructible<T>::value, "MemoryPool only supports trivially destructible types");
+
+public:
+    MemoryPool(std::size_t firstSlabSize = 64) : mNextSlabSize(firstSlabSize), mFreeList(nullptr),
+        mCurrentSlab(0), mNbFreeInSlab(0), mNbElements(0), mNbAllocations(0)
+    {
+
+    }
+
+    // Remove copy operations
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    // Accessors
+
+    std::size_t getNbElements() const
+    {
+        return mNbElements;
+    }
+
+    std::size_t getNbAllocations() const
+    {
+        return mNbAllocations;
+    }
+
+    std::size_t getNbSlabs() const
+    {
+        return mSlabs.size();
+    }
+
+    // Operations
+
+    template<typename... Args>
+    T* create(Args&&... args)
+    {
+        Slot* slot = mFreeList;
+        if (slot != nullptr)
+            mFreeList = slot->next;
+        else
+        {
+            if (mNbFreeInSlab == 0)
+                nextSlab();
+            slot = mSlabs[mCurrentSlab].get() + mSlabSizes[mCurrentSlab] - mNbFreeInSlab;
+            --mNbFreeInSlab;
+        }
+        ++mNbElements;
+        ++mNbAllocations;
+        return new (&slot->storage) T{std::forward<Args>(args)...};
+    }
+
+    void destroy(T* x)
+    {
+        Slot* slot = reinterpret_cast<Slot*>(x);
+        slot->next = mFreeList;
+        mFreeList = slot;
+        --mNbElements;
+    }
+
+    // Release all the elements but keep the slabs
+    void clear()
+    {
+        mFreeList = nullptr;
+        mCurrentSlab = 0;
+        mNbFreeInSlab = mSlabSizes.empty() ? 0 : mSlabSizes.front();
+        mNbElements = 0;
+        mNbAllocations = 0;
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> mSlabs;
+    std::vector<std::size_t> mSlabSizes;
+    std::size_t mNextSlabSize;
+    Slot* mFreeList;
+    std::size_t mCurrentSlab;
+    std::size_t mNbFreeInSlab;
+    std::size_t mNbElements;
+    std::size_t mNbAllocations;
+
+    void nextSlab()
+    {
+        if (!mSlabs.empty())
+            ++mCurrentSlab;
+        if (mCurrentSlab == mSlabs.size())
+        {
+            mSlabs.emplace_back(new Slot[mNextSlabSize]);
+            mSlabSizes.push_back(mNextSlabSize);
+            mNextSlabSize *= 2;
+        }
+        mNbFreeInSlab = mSlabSizes[mCurrentSlab];
+    }
+};
@@ -0,0 +1,45 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Number of threads to process n elements, 0 means one thread per hardware core
+// Each thread gets at least minElementsPerThread elements
+inline std::size_t getNbThreads(std::size_t nbThreads, std::size_t n, std::size_t minElementsPerThread)
+{
+    if (nbThreads == 0)
+        nbThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<std::size_t>(std::min(nbThreads, n / minElementsPerThread), 1);
+}
+
+// Call f(i) for i in [0, nbThreads), the call with i = 0 is made on the current thread
+template<typename F>
+void parallelFor(std::size_t nbThreads, F f)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(nbThreads - 1);
+    for (std::size_t i = 1; i < nbThreads; ++i)
+        threads.emplace_back(f, i);
+    f(0);
+    for (auto& thread : threads)
+        thread.join();
+}
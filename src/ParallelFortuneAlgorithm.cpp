@@ -0,0 +1,277 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ParallelFortuneAlgorithm.h"
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+// My includes
+#include "FortuneAlgorithm.h"
+#include "RadixSort.h"
+
+namespace
+{
+
+constexpr std::size_t MIN_SITES_PER_SLAB = 1024;
+// Initial margin in number of average distances between two sites
+constexpr double MARGIN_FACTOR = 4.0;
+
+}
+
+ParallelFortuneAlgorithm::ParallelFortuneAlgorithm(std::vector<Vector2> points, std::size_t nbThreads) :
+    mPoints(std::move(points)), mPool(nbThreads), mDiagram(mPoints)
+{
+
+}
+
+ParallelFortuneAlgorithm::~ParallelFortuneAlgorithm() = default;
+
+bool ParallelFortuneAlgorithm::construct(Box box)
+{
+    std::size_t n = mPoints.size();
+    if (n == 0)
+        return true;
+    sortSites();
+    // Partition the sites
+    std::size_t nbSlabs = std::max<std::size_t>(std::min(mPool.getNbThreads(), n / MIN_SITES_PER_SLAB), 1);
+    mSlabs.clear();
+    for (std::size_t i = 0; i < nbSlabs; ++i)
+        mSlabs.push_back(Slab{n * i / nbSlabs, n * (i + 1) / nbSlabs, 0, 0, VoronoiDiagram(std::vector<Vector2>()), false, 0});
+    // Compute the slabs
+    double margin = MARGIN_FACTOR * std::sqrt((box.right - box.left) * (box.top - box.bottom) / n);
+    mPool.run(nbSlabs, [this, box, margin](std::size_t i, std::size_t)
+    {
+        computeSlab(mSlabs[i], box, margin);
+    });
+    for (const Slab& slab : mSlabs)
+    {
+        if (!slab.valid)
+            return false;
+    }
+    return stitch();
+}
+
+VoronoiDiagram ParallelFortuneAlgorithm::getDiagram()
+{
+    return std::move(mDiagram);
+}
+
+std::size_t ParallelFortuneAlgorithm::getNbSlabs() const
+{
+    return mSlabs.size();
+}
+
+std::size_t ParallelFortuneAlgorithm::getNbRetries() const
+{
+    std::size_t nbRetries = 0;
+    for (const Slab& slab : mSlabs)
+        nbRetries += slab.nbRetries;
+    return nbRetries;
+}
+
+void ParallelFortuneAlgorithm::sortSites()
+{
+    std::vector<std::uint64_t> keys(mPoints.size());
+    mOrder.resize(mPoints.size());
+    for (std::size_t i = 0; i < mPoints.size(); ++i)
+    {
+        keys[i] = getRadixKey(mPoints[i].x);
+        mOrder[i] = static_cast<std::uint32_t>(i);
+    }
+    radixSort(keys, mOrder);
+}
+
+void ParallelFortuneAlgorithm::computeSlab(Slab& slab, Box box, double margin)
+{
+    std::size_t n = mPoints.size();
+    auto isLeftOf = [this](std::uint32_t i, double x){ return mPoints[i].x < x; };
+    auto isRightOf = [this](double x, std::uint32_t i){ return x < mPoints[i].x; };
+    while (true)
+    {
+        // Select the sites in the covered region
+        double left = slab.begin > 0 ? mPoints[mOrder[slab.begin]].x - margin : -std::numeric_limits<double>::infinity();
+        double right = slab.end < n ? mPoints[mOrder[slab.end - 1]].x + margin : std::numeric_limits<double>::infinity();
+        slab.localBegin = std::lower_bound(mOrder.begin(), mOrder.begin() + slab.begin, left, isLeftOf) - mOrder.begin();
+        slab.localEnd = std::upper_bound(mOrder.begin() + slab.end, mOrder.end(), right, isRightOf) - mOrder.begin();
+        std::vector<Vector2> points;
+        points.reserve(slab.localEnd - slab.localBegin);
+        for (std::size_t i = slab.localBegin; i < slab.localEnd; ++i)
+            points.push_back(mPoints[mOrder[i]]);
+        // Compute the diagram
+        FortuneAlgorithm algorithm(points);
+        algorithm.construct(FortuneAlgorithm::SiteEventMode::SORTED);
+        bool valid = algorithm.finalize(box);
+        slab.diagram = algorithm.getDiagram();
+        if (!valid)
+        {
+            slab.valid = false;
+            return;
+        }
+        // Check that no other site can modify the owned cells
+        bool complete = slab.localBegin == 0 && slab.localEnd == n;
+        if (complete || isCertified(slab, left, right))
+        {
+            slab.valid = true;
+            return;
+        }
+        margin *= 2.0;
+        ++slab.nbRetries;
+    }
+}
+
+bool ParallelFortuneAlgorithm::isCertified(const Slab& slab, double left, double right) const
+{
+    for (std::size_t i = slab.begin; i < slab.end; ++i)
+    {
+        const VoronoiDiagram::Site* site = slab.diagram.getSite(i - slab.localBegin);
+        const VoronoiDiagram::HalfEdge* start = site->face->outerComponent;
+        if (start == nullptr)
+            continue;
+        const VoronoiDiagram::HalfEdge* halfEdge = start;
+        do
+        {
+            // The empty circle centered at the vertex must be in the covered region
+            Vector2 point = halfEdge->origin->point;
+            double radius = point.getDistance(site->point);
+            if (point.x - radius < left || point.x + radius > right)
+                return false;
+            halfEdge = halfEdge->next;
+        } while (halfEdge != start);
+    }
+    return true;
+}
+
+bool ParallelFortuneAlgorithm::stitch()
+{
+    std::uint64_t n = mPoints.size();
+    mDiagram.reset(mPoints);
+    // Copy the certified cells
+    std::unordered_map<std::uint64_t, VoronoiDiagram::HalfEdge*> seams;
+    for (const Slab& slab : mSlabs)
+        copySlab(slab, seams);
+    // Match the half edges along the seams and merge their vertices
+    std::vector<VoronoiDiagram::Vertex*> vertices;
+    vertices.reserve(mDiagram.mVertices.getSize());
+    for (VoronoiDiagram::Vertex& vertex : mDiagram.mVertices)
+        vertices.push_back(&vertex);
+    std::vector<std::size_t> parents(vertices.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    auto merge = [this, &parents](const VoronoiDiagram::Vertex* vertex1, const VoronoiDiagram::Vertex* vertex2)
+    {
+        std::size_t i = findVertex(parents, vertex1->index);
+        std::size_t j = findVertex(parents, vertex2->index);
+        // The vertex created first is kept
+        parents[std::max(i, j)] = std::min(i, j);
+    };
+    bool valid = true;
+    for (const auto& seam : seams)
+    {
+        std::uint64_t i = seam.first / n;
+        std::uint64_t j = seam.first % n;
+        auto it = seams.find(j * n + i);
+        if (it == seams.end())
+            valid = false;
+        else if (i < j)
+        {
+            VoronoiDiagram::HalfEdge* halfEdge = seam.second;
+            VoronoiDiagram::HalfEdge* twin = it->second;
+            halfEdge->twin = twin;
+            twin->twin = halfEdge;
+            merge(halfEdge->origin, twin->destination);
+            merge(halfEdge->destination, twin->origin);
+        }
+    }
+    for (VoronoiDiagram::HalfEdge& halfEdge : mDiagram.mHalfEdges)
+    {
+        halfEdge.origin = vertices[findVertex(parents, halfEdge.origin->index)];
+        halfEdge.destination = vertices[findVertex(parents, halfEdge.destination->index)];
+    }
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        if (findVertex(parents, i) != i)
+            mDiagram.removeVertex(vertices[i]);
+    }
+    mDiagram.compact();
+    return valid;
+}
+
+void ParallelFortuneAlgorithm::copySlab(const Slab& slab, std::unordered_map<std::uint64_t, VoronoiDiagram::HalfEdge*>& seams)
+{
+    std::uint64_t n = mPoints.size();
+    const VoronoiDiagram& diagram = slab.diagram;
+    std::vector<VoronoiDiagram::Vertex*> vertices(diagram.mVertices.getSize(), nullptr);
+    std::vector<VoronoiDiagram::HalfEdge*> halfEdges(diagram.mHalfEdges.getSize(), nullptr);
+    auto getVertex = [this, &vertices](const VoronoiDiagram::Vertex* vertex)
+    {
+        VoronoiDiagram::Vertex*& copy = vertices[vertex->index];
+        if (copy == nullptr)
+            copy = mDiagram.createVertex(vertex->point);
+        return copy;
+    };
+    // Copy the half edges of the owned cells
+    for (std::size_t i = slab.begin; i < slab.end; ++i)
+    {
+        const VoronoiDiagram::HalfEdge* start = diagram.mFaces[i - slab.localBegin].outerComponent;
+        if (start == nullptr)
+            continue;
+        VoronoiDiagram::Face* face = mDiagram.getFace(mOrder[i]);
+        const VoronoiDiagram::HalfEdge* halfEdge = start;
+        do
+        {
+            VoronoiDiagram::HalfEdge* copy = mDiagram.createHalfEdge(face);
+            copy->origin = getVertex(halfEdge->origin);
+            copy->destination = getVertex(halfEdge->destination);
+            halfEdges[halfEdge->index] = copy;
+            halfEdge = halfEdge->next;
+        } while (halfEdge != start);
+    }
+    // Link them
+    for (std::size_t i = slab.begin; i < slab.end; ++i)
+    {
+        const VoronoiDiagram::HalfEdge* start = diagram.mFaces[i - slab.localBegin].outerComponent;
+        if (start == nullptr)
+            continue;
+        const VoronoiDiagram::HalfEdge* halfEdge = start;
+        do
+        {
+            VoronoiDiagram::HalfEdge* copy = halfEdges[halfEdge->index];
+            copy->prev = halfEdges[halfEdge->prev->index];
+            copy->next = halfEdges[halfEdge->next->index];
+            if (halfEdge->twin != nullptr)
+            {
+                std::size_t j = halfEdge->twin->incidentFace->site->index + slab.localBegin;
+                if (j >= slab.begin && j < slab.end)
+                    copy->twin = halfEdges[halfEdge->twin->index];
+                else
+                    seams[mOrder[i] * n + mOrder[j]] = copy;
+            }
+            halfEdge = halfEdge->next;
+        } while (halfEdge != start);
+    }
+}
+
+std::size_t ParallelFortuneAlgorithm::findVertex(std::vector<std::size_t>& parents, std::size_t i) const
+{
+    while (parents[i] != i)
+    {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
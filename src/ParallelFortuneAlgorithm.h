@@ -0,0 +1,77 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstdint>
+#include <unordered_map>
+// My includes
+#include "VoronoiDiagram.h"
+#include "ThreadPool.h"
+
+// Construction of a diagram intersected with a box using several threads
+// The sites are partitioned into vertical slabs. Each slab is swept independently with
+// the sites of its neighbors closer than a margin. A cell is kept only if the empty
+// circles centered at its vertices are inside the region covered by the slab, which
+// guarantees that no site outside the slab can modify it, otherwise the slab is
+// computed again with a larger margin. The cells are finally stitched along the seams.
+// The result is the same as calling construct, bound and intersect with the box.
+class ParallelFortuneAlgorithm
+{
+public:
+    // nbThreads = 0 means one thread per hardware core
+    ParallelFortuneAlgorithm(std::vector<Vector2> points, std::size_t nbThreads = 0);
+    ~ParallelFortuneAlgorithm();
+
+    bool construct(Box box);
+
+    VoronoiDiagram getDiagram();
+
+    // Statistics
+    std::size_t getNbSlabs() const;
+    std::size_t getNbRetries() const;
+
+private:
+    struct Slab
+    {
+        // Ranges in the sites sorted by x
+        std::size_t begin; // Owned sites
+        std::size_t end;
+        std::size_t localBegin; // Owned sites and their neighbors
+        std::size_t localEnd;
+        VoronoiDiagram diagram;
+        bool valid;
+        std::size_t nbRetries;
+    };
+
+    std::vector<Vector2> mPoints;
+    ThreadPool mPool;
+    VoronoiDiagram mDiagram;
+    std::vector<std::uint32_t> mOrder; // Indices of the sites sorted by x
+    std::vector<Slab> mSlabs;
+
+    // Slabs
+    void sortSites();
+    void computeSlab(Slab& slab, Box box, double margin);
+    bool isCertified(const Slab& slab, double left, double right) const;
+
+    // Stitching
+    bool stitch();
+    void copySlab(const Slab& slab, std::unordered_map<std::uint64_t, VoronoiDiagram::HalfEdge*>& seams);
+    std::size_t findVertex(std::vector<std::size_t>& parents, std::size_t i) const;
+};
@@ -0,0 +1,68 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>
+#include <vector>
+// My includes
+#include "Vector2.h"
+
+// Non-owning view over points stored by the caller, the memory must stay valid while the view is used
+// The coordinates of two consecutive points are separated by a stride in bytes, so that the view can refer to:
+// - separate arrays of x and y, the stride is sizeof(T)
+// - interleaved arrays or arrays of structures, for example a mapped file of pairs of doubles with a stride of 16
+// - a vector of Vector2, the conversion is implicit
+template<typename T>
+class BasicPointView
+{
+public:
+    using Scalar = T;
+    using Vector2 = BasicVector2<T>;
+
+    BasicPointView(const T* x, const T* y, std::size_t size, std::size_t stride = sizeof(T)) :
+        mX(reinterpret_cast<const char*>(x)), mY(reinterpret_cast<const char*>(y)), mSize(size), mStride(stride)
+    {
+
+    }
+
+    BasicPointView(const std::vector<Vector2>& points) :
+        BasicPointView(points.empty() ? nullptr : &points[0].x, points.empty() ? nullptr : &points[0].y,
+            points.size(), sizeof(Vector2))
+    {
+
+    }
+
+    std::size_t getSize() const
+    {
+        return mSize;
+    }
+
+    Vector2 operator[](std::size_t i) const
+    {
+        return Vector2(*reinterpret_cast<const T*>(mX + i * mStride), *reinterpret_cast<const T*>(mY + i * mStride));
+    }
+
+private:
+    const char* mX;
+    const char* mY;
+    std::size_t mSize;
+    std::size_t mStride;
+};
+
+using PointView = BasicPointView<double>;
@@ -0,0 +1,121 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RadixSort.h"
+// STL
+#include <algorithm>
+#include <array>
+#include <cstring>
+// My includes
+#include "Parallel.h"
+
+namespace
+{
+
+constexpr std::size_t DIGIT_BITS = 11;
+constexpr std::size_t NB_BUCKETS = std::size_t(1) << DIGIT_BITS;
+constexpr std::size_t NB_PASSES = (64 + DIGIT_BITS - 1) / DIGIT_BITS;
+constexpr std::size_t MIN_ELEMENTS_PER_THREAD = std::size_t(1) << 16;
+
+inline std::size_t getDigit(std::uint64_t key, std::size_t pass)
+{
+    return (key >> (pass * DIGIT_BITS)) & (NB_BUCKETS - 1);
+}
+
+}
+
+std::uint64_t getRadixKey(float x)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    std::uint32_t mask = (bits >> 31) != 0 ? ~std::uint32_t(0) : std::uint32_t(1) << 31;
+    return bits ^ mask;
+}
+
+std::uint64_t getRadixKey(double x)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    // Flip all the bits of negative numbers and only the sign bit of positive ones
+    std::uint64_t mask = (bits >> 63) != 0 ? ~std::uint64_t(0) : std::uint64_t(1) << 63;
+    return bits ^ mask;
+}
+
+void radixSort(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& values, std::size_t nbThreads)
+{
+    RadixSortBuffers buffers;
+    radixSort(keys, values, buffers, nbThreads);
+}
+
+void radixSort(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& values, RadixSortBuffers& buffers,
+    std::size_t nbThreads)
+{
+    std::size_t n = keys.size();
+    if (n < 2)
+        return;
+    nbThreads = getNbThreads(nbThreads, n, MIN_ELEMENTS_PER_THREAD);
+    std::vector<std::uint64_t>& tmpKeys = buffers.keys;
+    std::vector<std::uint32_t>& tmpValues = buffers.values;
+    std::vector<std::size_t>& histograms = buffers.histograms;
+    tmpKeys.resize(n);
+    tmpValues.resize(n);
+    histograms.resize(nbThreads * NB_BUCKETS);
+    auto getChunkBegin = [n, nbThreads](std::size_t i){ return n * i / nbThreads; };
+    for (std::size_t pass = 0; pass < NB_PASSES; ++pass)
+    {
+        // Count the digits in each chunk
+        std::fill(histograms.begin(), histograms.end(), 0);
+        parallelFor(nbThreads, [&](std::size_t i)
+        {
+            std::size_t* histogram = histograms.data() + i * NB_BUCKETS;
+            for (std::size_t j = getChunkBegin(i); j < getChunkBegin(i + 1); ++j)
+                ++histogram[getDigit(keys[j], pass)];
+        });
+        // Skip the pass if all the keys share the same digit
+        std::size_t firstBucket = getDigit(keys.front(), pass);
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < nbThreads; ++i)
+            count += histograms[i * NB_BUCKETS + firstBucket];
+        if (count == n)
+            continue;
+        // Compute the offsets of each chunk in each bucket
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < NB_BUCKETS; ++bucket)
+        {
+            for (std::size_t i = 0; i < nbThreads; ++i)
+            {
+                std::size_t& entry = histograms[i * NB_BUCKETS + bucket];
+                std::size_t size = entry;
+                entry = offset;
+                offset += size;
+            }
+        }
+        // Scatter
+        parallelFor(nbThreads, [&](std::size_t i)
+        {
+            std::size_t* offsets = histograms.data() + i * NB_BUCKETS;
+            for (std::size_t j = getChunkBegin(i); j < getChunkBegin(i + 1); ++j)
+            {
+                std::size_t k = offsets[getDigit(keys[j], pass)]++;
+                tmpKeys[k] = keys[j];
+                tmpValues[k] = values[j];
+            }
+        });
+        keys.swap(tmpKeys);
+        values.swap(tmpValues);
+    }
+}
@@ -0,0 +1,40 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Map a float or a double to an unsigned integer with the same ordering
+std::uint64_t getRadixKey(float x);
+std::uint64_t getRadixKey(double x);
+
+// Scratch memory that can be reused between sorts
+struct RadixSortBuffers
+{
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> values;
+    std::vector<std::size_t> histograms;
+};
+
+// Stable LSD radix sort of (key, value) pairs by increasing keys
+// nbThreads = 0 means one thread per hardware core
+void radixSort(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& values, std::size_t nbThreads = 0);
+void radixSort(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& values, RadixSortBuffers& buffers,
+    std::size_t nbThreads = 0);
@@ -0,0 +1,88 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Bounded first-in first-out queue between a producer thread and a consumer thread
+// The values are copied in the slots and swapped out of them so that the memory they own is reused
+template<typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(std::size_t capacity) : mSlots(std::max<std::size_t>(capacity, 1)), mBegin(0), mSize(0),
+        mClosed(false)
+    {
+
+    }
+
+    // Remove copy operations
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    std::size_t getCapacity() const
+    {
+        return mSlots.size();
+    }
+
+    // Wait for a free slot
+    void push(const T& value)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotFullCondition.wait(lock, [this]{ return mSize < mSlots.size(); });
+        mSlots[(mBegin + mSize) % mSlots.size()] = value;
+        ++mSize;
+        mNotEmptyCondition.notify_one();
+    }
+
+    // Wait for a value, return false once the buffer is closed and empty
+    bool pop(T& value)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNotEmptyCondition.wait(lock, [this]{ return mSize > 0 || mClosed; });
+        if (mSize == 0)
+            return false;
+        std::swap(value, mSlots[mBegin]);
+        mBegin = (mBegin + 1) % mSlots.size();
+        --mSize;
+        mNotFullCondition.notify_one();
+        return true;
+    }
+
+    // No value will be pushed anymore
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosed = true;
+        mNotEmptyCondition.notify_all();
+    }
+
+private:
+    std::vector<T> mSlots;
+    std::size_t mBegin;
+    std::size_t mSize;
+    bool mClosed;
+    std::mutex mMutex;
+    std::condition_variable mNotFullCondition;
+    std::condition_variable mNotEmptyCondition;
+};
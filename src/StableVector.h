@@ -0,0 +1,235 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+// Sequence of contiguous chunks whose elements never move when the container grows
+// A new chunk is only allocated when all the reserved capacity is used
+template<typename T>
+class StableVector
+{
+    template<typename U, typename Chunks>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = U*;
+        using reference = U&;
+
+        Iterator(Chunks* chunks, std::size_t chunk, std::size_t i) : mChunks(chunks), mChunk(chunk), mI(i)
+        {
+            skipEmptyChunks();
+        }
+
+        reference operator*() const
+        {
+            return (*mChunks)[mChunk][mI];
+        }
+
+        pointer operator->() const
+        {
+            return &(*mChunks)[mChunk][mI];
+        }
+
+        Iterator& operator++()
+        {
+            ++mI;
+            skipEmptyChunks();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return mChunk == other.mChunk && mI == other.mI;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        Chunks* mChunks;
+        std::size_t mChunk;
+        std::size_t mI;
+
+        void skipEmptyChunks()
+        {
+            while (mChunk < mChunks->size() && mI == (*mChunks)[mChunk].size())
+            {
+                ++mChunk;
+                mI = 0;
+            }
+        }
+    };
+
+public:
+    using iterator = Iterator<T, std::vector<std::vector<T>>>;
+    using const_iterator = Iterator<const T, const std::vector<std::vector<T>>>;
+
+    StableVector() : mSize(0), mCapacity(0), mCurrentChunk(0)
+    {
+
+    }
+
+    // The moved-from vector is left empty and without capacity
+    StableVector(StableVector&& other) noexcept : mChunks(std::move(other.mChunks)), mSize(other.mSize),
+        mCapacity(other.mCapacity), mCurrentChunk(other.mCurrentChunk)
+    {
+        other.release();
+    }
+
+    StableVector& operator=(StableVector&& other) noexcept
+    {
+        if (this != &other)
+        {
+            mChunks = std::move(other.mChunks);
+            mSize = other.mSize;
+            mCapacity = other.mCapacity;
+            mCurrentChunk = other.mCurrentChunk;
+            other.release();
+        }
+        return *this;
+    }
+
+    // Accessors
+
+    bool isEmpty() const
+    {
+        return mSize == 0;
+    }
+
+    std::size_t getSize() const
+    {
+        return mSize;
+    }
+
+    std::size_t getCapacity() const
+    {
+        return mCapacity;
+    }
+
+    T& operator[](std::size_t i)
+    {
+        std::size_t chunk = 0;
+        while (i >= mChunks[chunk].size())
+        {
+            i -= mChunks[chunk].size();
+            ++chunk;
+        }
+        return mChunks[chunk][i];
+    }
+
+    iterator begin()
+    {
+        return iterator(&mChunks, 0, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(&mChunks, mChunks.size(), 0);
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(&mChunks, 0, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(&mChunks, mChunks.size(), 0);
+    }
+
+    // Operations
+
+    void reserve(std::size_t capacity)
+    {
+        if (capacity > mCapacity)
+            allocateChunk(capacity - mCapacity);
+    }
+
+    template<typename... Args>
+    T* emplaceBack(Args&&... args)
+    {
+        while (mCurrentChunk < mChunks.size() && mChunks[mCurrentChunk].size() == mChunks[mCurrentChunk].capacity())
+            ++mCurrentChunk;
+        if (mCurrentChunk == mChunks.size())
+            allocateChunk(std::max(mCapacity / 2, MIN_CHUNK_SIZE));
+        mChunks[mCurrentChunk].emplace_back(std::forward<Args>(args)...);
+        ++mSize;
+        return &mChunks[mCurrentChunk].back();
+    }
+
+    // Remove all the elements but keep the chunks
+    void clear()
+    {
+        truncate(0);
+    }
+
+    // Keep only the first size elements
+    void truncate(std::size_t size)
+    {
+        mSize = size;
+        if (mChunks.empty())
+            mCapacity = 0;
+        for (mCurrentChunk = 0; mCurrentChunk < mChunks.size(); ++mCurrentChunk)
+        {
+            std::vector<T>& chunk = mChunks[mCurrentChunk];
+            if (size <= chunk.size())
+            {
+                chunk.erase(chunk.begin() + size, chunk.end());
+                for (std::size_t i = mCurrentChunk + 1; i < mChunks.size(); ++i)
+                    mChunks[i].clear();
+                break;
+            }
+            size -= chunk.size();
+        }
+    }
+
+private:
+    static constexpr std::size_t MIN_CHUNK_SIZE = 1024;
+
+    std::vector<std::vector<T>> mChunks;
+    std::size_t mSize;
+    std::size_t mCapacity;
+    std::size_t mCurrentChunk;
+
+    void release()
+    {
+        mChunks.clear();
+        mSize = 0;
+        mCapacity = 0;
+        mCurrentChunk = 0;
+    }
+
+    void allocateChunk(std::size_t capacity)
+    {
+        mChunks.emplace_back();
+        mChunks.back().reserve(capacity);
+        mCapacity += capacity;
+    }
+};
+
+template<typename T>
+constexpr std::size_t StableVector<T>::MIN_CHUNK_SIZE;
@@ -0,0 +1,78 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>
+
+// The counters are only updated if FORTUNE_STATISTICS is defined, otherwise they are compiled out
+#ifdef FORTUNE_STATISTICS
+#define FORTUNE_STATISTICS_ONLY(x) x
+#else
+#define FORTUNE_STATISTICS_ONLY(x)
+#endif
+
+// Counters collected during the construction of a diagram
+struct Statistics
+{
+#ifdef FORTUNE_STATISTICS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    // Events
+    std::size_t nbSiteEvents = 0;
+    std::size_t nbCircleEvents = 0; // Processed circle events
+    std::size_t nbTriplets = 0; // Triplets of arcs examined to find circle events
+    std::size_t nbCreatedCircleEvents = 0; // Triplets which passed the orientation test
+    std::size_t nbDeletedCircleEvents = 0; // Circle events invalidated before being processed
+    std::size_t maxEventQueueSize = 0; // Including the site events in heap mode
+    // Beachline
+    std::size_t maxBeachlineSize = 0;
+    std::size_t nbLocations = 0; // Calls to locateArcAbove
+    std::size_t nbHintedLocations = 0; // Calls starting from a hint
+    std::size_t nbLocationSteps = 0; // Nodes visited by locateArcAbove
+    std::size_t nbRootLocationSteps = 0; // Nodes a descent from the root would have visited
+    std::size_t nbRotations = 0;
+
+    // Fraction of the created circle events which are false alarms
+    double getFalseAlarmRate() const
+    {
+        return nbCreatedCircleEvents > 0 ? static_cast<double>(nbDeletedCircleEvents) / nbCreatedCircleEvents : 0.0;
+    }
+
+    // Fraction of the triplets which do not converge, they are all rejected by the orientation test before computing
+    // their convergence points
+    double getRejectionRate() const
+    {
+        return nbTriplets > 0 ? 1.0 - static_cast<double>(nbCreatedCircleEvents) / nbTriplets : 0.0;
+    }
+
+    double getAverageLocationDepth() const
+    {
+        return nbLocations > 0 ? static_cast<double>(nbLocationSteps) / nbLocations : 0.0;
+    }
+
+    // Average number of nodes the hints saved per location, negative if they cost more than they saved
+    double getAverageSavedLocationSteps() const
+    {
+        return nbLocations > 0 ?
+            (static_cast<double>(nbRootLocationSteps) - static_cast<double>(nbLocationSteps)) / nbLocations : 0.0;
+    }
+};
@@ -0,0 +1,161 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ThreadPool.h"
+// STL
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr std::uint64_t pack(std::uint64_t begin, std::uint64_t end)
+{
+    return (begin << 32) | end;
+}
+
+constexpr std::uint64_t getBegin(std::uint64_t range)
+{
+    return range >> 32;
+}
+
+constexpr std::uint64_t getEnd(std::uint64_t range)
+{
+    return range & std::numeric_limits<std::uint32_t>::max();
+}
+
+}
+
+ThreadPool::ThreadPool(std::size_t nbThreads) : mTask(nullptr), mNbActiveThreads(0), mGeneration(0), mStop(false)
+{
+    if (nbThreads == 0)
+        nbThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    mQueues.reset(new Queue[nbThreads]);
+    for (std::size_t i = 0; i < nbThreads; ++i)
+        mQueues[i].range = 0;
+    mThreads.reserve(nbThreads);
+    for (std::size_t i = 0; i < nbThreads; ++i)
+        mThreads.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mStartCondition.notify_all();
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+std::size_t ThreadPool::getNbThreads() const
+{
+    return mThreads.size();
+}
+
+void ThreadPool::run(std::size_t nbTasks, const Task& task)
+{
+    if (nbTasks == 0)
+        return;
+    if (nbTasks > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("Too many tasks");
+    std::unique_lock<std::mutex> lock(mMutex);
+    mTask = &task;
+    // Split the tasks evenly between the workers
+    for (std::size_t i = 0; i < mThreads.size(); ++i)
+        mQueues[i].range = pack(nbTasks * i / mThreads.size(), nbTasks * (i + 1) / mThreads.size());
+    mNbActiveThreads = mThreads.size();
+    mException = nullptr;
+    ++mGeneration;
+    mStartCondition.notify_all();
+    mEndCondition.wait(lock, [this]{ return mNbActiveThreads == 0; });
+    mTask = nullptr;
+    if (mException)
+        std::rethrow_exception(mException);
+}
+
+void ThreadPool::work(std::size_t thread)
+{
+    std::size_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStartCondition.wait(lock, [this, generation]{ return mStop || mGeneration != generation; });
+            if (mStop)
+                return;
+            generation = mGeneration;
+        }
+        // Take the tasks one by one, steal when there are no more
+        std::size_t i;
+        while (popTask(thread, i) || (stealTasks(thread) && popTask(thread, i)))
+        {
+            try
+            {
+                (*mTask)(i, thread);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mException)
+                    mException = std::current_exception();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mNbActiveThreads;
+        }
+        mEndCondition.notify_one();
+    }
+}
+
+bool ThreadPool::popTask(std::size_t thread, std::size_t& task)
+{
+    std::atomic<std::uint64_t>& range = mQueues[thread].range;
+    std::uint64_t current = range.load();
+    while (getBegin(current) < getEnd(current))
+    {
+        if (range.compare_exchange_weak(current, pack(getBegin(current) + 1, getEnd(current))))
+        {
+            task = getBegin(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::stealTasks(std::size_t thread)
+{
+    for (std::size_t i = 1; i < mThreads.size(); ++i)
+    {
+        std::atomic<std::uint64_t>& range = mQueues[(thread + i) % mThreads.size()].range;
+        std::uint64_t current = range.load();
+        while (getBegin(current) < getEnd(current))
+        {
+            std::uint64_t middle = getEnd(current) - (getEnd(current) - getBegin(current) + 1) / 2;
+            if (range.compare_exchange_weak(current, pack(getBegin(current), middle)))
+            {
+                // The queue of the thief is empty so nobody else can modify it
+                mQueues[thread].range = pack(middle, getEnd(current));
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,78 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads executing batches of indexed tasks
+// Each worker starts with a contiguous range of tasks and, once it is exhausted,
+// steals the second half of the range of another worker
+class ThreadPool
+{
+public:
+    // Arguments: index of the task, index of the worker thread
+    using Task = std::function<void(std::size_t, std::size_t)>;
+
+    // nbThreads = 0 means one thread per hardware core
+    explicit ThreadPool(std::size_t nbThreads = 0);
+    ~ThreadPool();
+
+    // Remove copy and move operations
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    std::size_t getNbThreads() const;
+
+    // Execute task for all indices in [0, nbTasks) and wait for completion
+    // The first exception thrown by a task is rethrown
+    void run(std::size_t nbTasks, const Task& task);
+
+private:
+    // Range of tasks [begin, end) packed as (begin << 32) | end, padded to avoid false sharing
+    struct Queue
+    {
+        std::atomic<std::uint64_t> range;
+        char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+    };
+
+    std::vector<std::thread> mThreads;
+    std::unique_ptr<Queue[]> mQueues;
+    std::mutex mMutex;
+    std::condition_variable mStartCondition;
+    std::condition_variable mEndCondition;
+    const Task* mTask;
+    std::size_t mNbActiveThreads;
+    std::size_t mGeneration;
+    std::exception_ptr mException;
+    bool mStop;
+
+    void work(std::size_t thread);
+    bool popTask(std::size_t thread, std::size_t& task);
+    bool stealTasks(std::size_t thread);
+};
@@ -18,44 +18,152 @@
 #pragma once
 
 // STL
+#include <cmath>
 #include <ostream>
+#include <vector>
 
 // Declarations
 
-class Vector2;
-Vector2 operator-(Vector2 lhs, const Vector2& rhs);
+template<typename T>
+class BasicVector2;
+template<typename T>
+BasicVector2<T> operator-(BasicVector2<T> lhs, const BasicVector2<T>& rhs);
 
 // Implementations
 
-class Vector2
+// T is the scalar type of the coordinates: float, double or long double
+template<typename T>
+class BasicVector2
 {
 public:
-    double x;
-    double y;
+    using Scalar = T;
+
+    T x;
+    T y;
+
+    BasicVector2(T x = T(0), T y = T(0)) : x(x), y(y)
+    {
+
+    }
 
-    Vector2(double x = 0.0, double y = 0.0);
-    
     // Unary operators
 
-    Vector2 operator-() const;
-    Vector2& operator+=(const Vector2& other);
-    Vector2& operator-=(const Vector2& other);
-    Vector2& operator*=(double t);
-    
+    BasicVector2 operator-() const
+    {
+        return BasicVector2(-x, -y);
+    }
+
+    BasicVector2& operator+=(const BasicVector2& other)
+    {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+
+    BasicVector2& operator-=(const BasicVector2& other)
+    {
+        x -= other.x;
+        y -= other.y;
+        return *this;
+    }
+
+    BasicVector2& operator*=(T t)
+    {
+        x *= t;
+        y *= t;
+        return *this;
+    }
+
     // Other operations
-    
-    Vector2 getOrthogonal() const;
-    double dot(const Vector2& other) const;
-    double getNorm() const;
-    double getDistance(const Vector2& other) const;
-    double getDet(const Vector2& other) const;
+
+    BasicVector2 getOrthogonal() const
+    {
+        return BasicVector2(-y, x);
+    }
+
+    T dot(const BasicVector2& other) const
+    {
+        return x * other.x + y * other.y;
+    }
+
+    T getNorm() const
+    {
+        return std::sqrt(x * x + y * y);
+    }
+
+    T getDistance(const BasicVector2& other) const
+    {
+        return (*this - other).getNorm();
+    }
+
+    T getDet(const BasicVector2& other) const
+    {
+        return x * other.y - y * other.x;
+    }
 };
 
-// Binary operators
+// Binary operators, the scalar of the products is not deduced so that literals convert to T
+
+template<typename T>
+BasicVector2<T> operator+(BasicVector2<T> lhs, const BasicVector2<T>& rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+template<typename T>
+BasicVector2<T> operator-(BasicVector2<T> lhs, const BasicVector2<T>& rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+template<typename T>
+BasicVector2<T> operator*(typename BasicVector2<T>::Scalar t, BasicVector2<T> vec)
+{
+    vec *= t;
+    return vec;
+}
+
+template<typename T>
+BasicVector2<T> operator*(BasicVector2<T> vec, typename BasicVector2<T>::Scalar t)
+{
+    return t * vec;
+}
+
+template<typename T>
+std::ostream& operator<<(std::ostream& os, const BasicVector2<T>& vec)
+{
+    os << "(" << vec.x << ", " << vec.y << ")";
+    return os;
+}
+
+// Vectors stored in structure of arrays layout, used by the batched functions of Box
+
+template<typename T>
+struct BasicVector2Array
+{
+    std::vector<T> x;
+    std::vector<T> y;
+
+    std::size_t getSize() const
+    {
+        return x.size();
+    }
+
+    void clear()
+    {
+        x.clear();
+        y.clear();
+    }
+
+    void pushBack(const BasicVector2<T>& vec)
+    {
+        x.push_back(vec.x);
+        y.push_back(vec.y);
+    }
+};
 
-Vector2 operator+(Vector2 lhs, const Vector2& rhs);
-Vector2 operator-(Vector2 lhs, const Vector2& rhs);
-Vector2 operator*(double t, Vector2 vec);
-Vector2 operator*(Vector2 vec, double t);
-std::ostream& operator<<(std::ostream& os, const Vector2& vec);
+using Vector2 = BasicVector2<double>;
+using Vector2Array = BasicVector2Array<double>;
 
@@ -17,206 +17,518 @@
 
 #include "VoronoiDiagram.h"
 // STL
-#include <unordered_set>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+// My includes
+#include "Parallel.h"
 
-VoronoiDiagram::VoronoiDiagram(const std::vector<Vector2>& points)
+namespace
 {
-    mSites.reserve(points.size());
-    mFaces.reserve(points.size());
-    for(std::size_t i = 0; i < points.size(); ++i)
+
+constexpr std::size_t MIN_FACES_PER_THREAD = std::size_t(1) << 15;
+
+}
+
+template<typename T>
+constexpr std::size_t BasicVoronoiDiagram<T>::REMOVED;
+
+template<typename T>
+BasicVoronoiDiagram<T>::BasicVoronoiDiagram(PointView points)
+{
+    reset(points);
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::reset(PointView points)
+{
+    mSites.clear();
+    mFaces.clear();
+    mVertices.clear();
+    mHalfEdges.clear();
+    mFreeVertices.clear();
+    mFreeHalfEdges.clear();
+    mDirty = false;
+    mVertexBox = Box{std::numeric_limits<T>::infinity(), std::numeric_limits<T>::infinity(),
+        -std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity()};
+    mSites.reserve(points.getSize());
+    mFaces.reserve(points.getSize());
+    // Upper bounds for the construction given by Euler's formula
+    mVertices.reserve(2 * points.getSize());
+    mHalfEdges.reserve(6 * points.getSize());
+    for(std::size_t i = 0; i < points.getSize(); ++i)
     {
-        mSites.push_back(VoronoiDiagram::Site{i, points[i], nullptr});
-        mFaces.push_back(VoronoiDiagram::Face{&mSites.back(), nullptr});
+        mSites.push_back(Site{i, points[i], nullptr});
+        mFaces.push_back(Face{&mSites.back(), nullptr});
         mSites.back().face = &mFaces.back();
     }
 }
 
-VoronoiDiagram::Site* VoronoiDiagram::getSite(std::size_t i)
+template<typename T>
+typename BasicVoronoiDiagram<T>::Site* BasicVoronoiDiagram<T>::getSite(std::size_t i)
 {
     return &mSites[i];
 }
 
-std::size_t VoronoiDiagram::getNbSites() const
+template<typename T>
+const typename BasicVoronoiDiagram<T>::Site* BasicVoronoiDiagram<T>::getSite(std::size_t i) const
+{
+    return &mSites[i];
+}
+
+template<typename T>
+std::size_t BasicVoronoiDiagram<T>::getNbSites() const
 {
     return mSites.size();
 }
 
-VoronoiDiagram::Face* VoronoiDiagram::getFace(std::size_t i)
+template<typename T>
+typename BasicVoronoiDiagram<T>::Face* BasicVoronoiDiagram<T>::getFace(std::size_t i)
 {
     return &mFaces[i];
 }
 
-const std::list<VoronoiDiagram::Vertex>& VoronoiDiagram::getVertices() const
+template<typename T>
+const StableVector<typename BasicVoronoiDiagram<T>::Vertex>& BasicVoronoiDiagram<T>::getVertices() const
 {
     return mVertices;
 }
 
-const std::list<VoronoiDiagram::HalfEdge>& VoronoiDiagram::getHalfEdges() const
+template<typename T>
+const StableVector<typename BasicVoronoiDiagram<T>::HalfEdge>& BasicVoronoiDiagram<T>::getHalfEdges() const
 {
     return mHalfEdges;
 }
 
-bool VoronoiDiagram::intersect(Box box)
+template<typename T>
+bool BasicVoronoiDiagram<T>::intersect(Box box, std::size_t nbThreads)
 {
-    bool error = false;
-    std::unordered_set<HalfEdge*> processedHalfEdges;
-    std::unordered_set<Vertex*> verticesToRemove;
-    for (const Site& site : mSites)
+    nbThreads = getNbThreads(nbThreads, mFaces.size(), MIN_FACES_PER_THREAD);
+    auto getChunkBegin = [this, nbThreads](std::size_t i){ return mFaces.size() * i / nbThreads; };
+    // Find the half edges with an end outside the box, the faces inside the box are left untouched
+    std::vector<char> crossingHalfEdges(mHalfEdges.getSize(), false);
+    std::vector<CrossingCandidates> candidates(nbThreads);
+    std::vector<std::vector<Crossing>> crossings(nbThreads);
+    std::vector<std::vector<BorderFace>> borderFaces(nbThreads);
+    std::vector<char> errors(nbThreads, false);
+    parallelFor(nbThreads, [&](std::size_t i)
     {
-        HalfEdge* halfEdge = site.face->outerComponent;
-        bool inside = box.contains(halfEdge->origin->point);
-        bool outerComponentDirty = !inside;
-        HalfEdge* incomingHalfEdge = nullptr; // First half edge coming in the box
-        HalfEdge* outgoingHalfEdge = nullptr; // Last half edge going out the box
-        Box::Side incomingSide, outgoingSide;
-        do
+        for (std::size_t j = getChunkBegin(i); j < getChunkBegin(i + 1); ++j)
         {
-            std::array<Box::Intersection, 2> intersections;
-            int nbIntersections = box.getIntersections(halfEdge->origin->point, halfEdge->destination->point, intersections);
-            bool nextInside = box.contains(halfEdge->destination->point);
-            HalfEdge* nextHalfEdge = halfEdge->next;
-            // The two points are outside the box 
-            if (!inside && !nextInside)
-            {
-                // The edge is outside the box
-                if (nbIntersections == 0)
-                {
-                    verticesToRemove.emplace(halfEdge->origin);
-                    removeHalfEdge(halfEdge);
-                }
-                // The edge crosses twice the frontiers of the box
-                else if (nbIntersections == 2)
-                {
-                    verticesToRemove.emplace(halfEdge->origin);
-                    if (processedHalfEdges.find(halfEdge->twin) != processedHalfEdges.end())
-                    {
-                        halfEdge->origin = halfEdge->twin->destination;
-                        halfEdge->destination = halfEdge->twin->origin;
-                    }
-                    else
-                    {
-                        halfEdge->origin = createVertex(intersections[0].point);
-                        halfEdge->destination = createVertex(intersections[1].point);
-                    }
-                    if (outgoingHalfEdge != nullptr)
-                        link(box, outgoingHalfEdge, outgoingSide, halfEdge, intersections[0].side);
-                    if (incomingHalfEdge == nullptr)
-                    {
-                       incomingHalfEdge = halfEdge;
-                       incomingSide = intersections[0].side;
-                    }
-                    outgoingHalfEdge = halfEdge;
-                    outgoingSide = intersections[1].side;
-                    processedHalfEdges.emplace(halfEdge);
-                }
-                else
-                    error = true;
-            }
-            // The edge is going outside the box
-            else if (inside && !nextInside)
+            Face* face = &mFaces[j];
+            if (face->outerComponent == nullptr)
+                continue;
+            std::size_t firstCandidate = candidates[i].halfEdges.size();
+            bool outerComponentDirty = !box.contains(face->outerComponent->origin->point);
+            findCandidates(box, face, candidates[i]);
+            if (candidates[i].halfEdges.size() > firstCandidate)
+                borderFaces[i].push_back(BorderFace{face, outerComponentDirty, firstCandidate, candidates[i].halfEdges.size(),
+                    0, 0, 0, 0});
+        }
+        // Intersect all the candidates of the chunk with the box at once
+        box.getIntersections(candidates[i].origins, candidates[i].destinations, candidates[i].nbIntersections,
+            candidates[i].intersections);
+        for (BorderFace& borderFace : borderFaces[i])
+        {
+            if (!findCrossings(borderFace, candidates[i], crossings[i], crossingHalfEdges))
+                errors[i] = true;
+        }
+    });
+    // Count the new vertices and half edges of each face
+    parallelFor(nbThreads, [&](std::size_t i)
+    {
+        for (BorderFace& borderFace : borderFaces[i])
+            clipFace(box, borderFace, crossings[i], crossingHalfEdges, ClipPass::COUNT, nullptr, nullptr);
+    });
+    // Allocate them in the order of the faces, the result does not depend on the number of threads
+    std::vector<Vertex*> vertices;
+    std::vector<HalfEdge*> halfEdges;
+    for (std::vector<BorderFace>& threadBorderFaces : borderFaces)
+    {
+        for (BorderFace& borderFace : threadBorderFaces)
+        {
+            borderFace.firstVertex = vertices.size();
+            for (std::size_t i = 0; i < borderFace.nbVertices; ++i)
             {
-                if (nbIntersections == 1)
-                {
-                    if (processedHalfEdges.find(halfEdge->twin) != processedHalfEdges.end())
-                        halfEdge->destination = halfEdge->twin->origin;
-                    else
-                        halfEdge->destination = createVertex(intersections[0].point);
-                    outgoingHalfEdge = halfEdge;
-                    outgoingSide = intersections[0].side;
-                    processedHalfEdges.emplace(halfEdge);
-                }
-                else
-                    error = true;
+                vertices.push_back(mVertices.emplaceBack());
+                vertices.back()->index = mVertices.getSize() - 1;
             }
-            // The edge is coming inside the box
-            else if (!inside && nextInside)
+            borderFace.firstHalfEdge = halfEdges.size();
+            for (std::size_t i = 0; i < borderFace.nbHalfEdges; ++i)
             {
-                if (nbIntersections == 1)
-                {
-                    verticesToRemove.emplace(halfEdge->origin);
-                    if (processedHalfEdges.find(halfEdge->twin) != processedHalfEdges.end())
-                        halfEdge->origin = halfEdge->twin->destination;
-                    else
-                        halfEdge->origin = createVertex(intersections[0].point);
-                    if (outgoingHalfEdge != nullptr)
-                        link(box, outgoingHalfEdge, outgoingSide, halfEdge, intersections[0].side);
-                    if (incomingHalfEdge == nullptr)
-                    {
-                       incomingHalfEdge = halfEdge;
-                       incomingSide = intersections[0].side;
-                    }
-                    processedHalfEdges.emplace(halfEdge);
-                }
-                else
-                    error = true;
+                halfEdges.push_back(mHalfEdges.emplaceBack());
+                halfEdges.back()->index = mHalfEdges.getSize() - 1;
             }
-            halfEdge = nextHalfEdge;
-            // Update inside
-            inside = nextInside;
-        } while (halfEdge != site.face->outerComponent);
-        // Link the last and the first half edges inside the box
-        if (outerComponentDirty && incomingHalfEdge != nullptr)
-            link(box, outgoingHalfEdge, outgoingSide, incomingHalfEdge, incomingSide);
-        // Set outer component
-        if (outerComponentDirty)
-            site.face->outerComponent = incomingHalfEdge;
-    }
-    // Remove vertices
-    for (auto& vertex : verticesToRemove)
-        removeVertex(vertex);
+        }
+    }
+    // Create the intersections first so that the twins can reuse them when linking
+    for (ClipPass pass : {ClipPass::INTERSECTIONS, ClipPass::LINKS})
+    {
+        parallelFor(nbThreads, [&](std::size_t i)
+        {
+            for (BorderFace& borderFace : borderFaces[i])
+                clipFace(box, borderFace, crossings[i], crossingHalfEdges, pass,
+                    vertices.data() + borderFace.firstVertex, halfEdges.data() + borderFace.firstHalfEdge);
+        });
+    }
+    for (const Vertex* vertex : vertices)
+    {
+        mVertexBox.left = std::min(vertex->point.x, mVertexBox.left);
+        mVertexBox.bottom = std::min(vertex->point.y, mVertexBox.bottom);
+        mVertexBox.right = std::max(vertex->point.x, mVertexBox.right);
+        mVertexBox.top = std::max(vertex->point.y, mVertexBox.top);
+    }
+    // Remove the half edges and the vertices outside the box
+    for (const std::vector<Crossing>& threadCrossings : crossings)
+    {
+        for (const Crossing& crossing : threadCrossings)
+        {
+            if (crossing.type == CrossingType::OUTSIDE)
+                removeHalfEdge(crossing.halfEdge);
+            if (crossing.type != CrossingType::OUTGOING)
+                removeVertex(crossing.origin);
+        }
+    }
+    compact();
     // Return the status
-    return !error;
+    return std::find(errors.begin(), errors.end(), true) == errors.end();
+}
+
+template<typename T>
+FrozenDiagram BasicVoronoiDiagram<T>::freeze() const
+{
+    using Index = FrozenDiagram::Index;
+    if (mSites.size() >= FrozenDiagram::INVALID_INDEX || mVertices.getSize() >= FrozenDiagram::INVALID_INDEX ||
+        2 * mHalfEdges.getSize() >= FrozenDiagram::INVALID_INDEX)
+        throw std::length_error("The diagram is too large to be indexed with 32-bit integers");
+    // Assign consecutive indices to twins
+    std::vector<Index> halfEdgeIndices(mHalfEdges.getSize(), FrozenDiagram::INVALID_INDEX);
+    Index nbHalfEdges = 0;
+    for (const HalfEdge& halfEdge : mHalfEdges)
+    {
+        if (halfEdgeIndices[halfEdge.index] != FrozenDiagram::INVALID_INDEX)
+            continue;
+        halfEdgeIndices[halfEdge.index] = nbHalfEdges;
+        if (halfEdge.twin != nullptr)
+            halfEdgeIndices[halfEdge.twin->index] = nbHalfEdges + 1;
+        nbHalfEdges += 2;
+    }
+    auto getVertexIndex = [](const Vertex* vertex)
+    {
+        return vertex != nullptr ? static_cast<Index>(vertex->index) : FrozenDiagram::INVALID_INDEX;
+    };
+    auto getHalfEdgeIndex = [&halfEdgeIndices](const HalfEdge* halfEdge)
+    {
+        return halfEdge != nullptr ? halfEdgeIndices[halfEdge->index] : FrozenDiagram::INVALID_INDEX;
+    };
+    // Fill the arrays
+    std::vector<BasicVector2<double>> sitePoints;
+    std::vector<Index> outerComponents;
+    sitePoints.reserve(mSites.size());
+    outerComponents.reserve(mSites.size());
+    for (const Site& site : mSites)
+    {
+        sitePoints.emplace_back(static_cast<double>(site.point.x), static_cast<double>(site.point.y));
+        outerComponents.push_back(getHalfEdgeIndex(site.face->outerComponent));
+    }
+    std::vector<BasicVector2<double>> vertexPoints;
+    vertexPoints.reserve(mVertices.getSize());
+    for (const Vertex& vertex : mVertices)
+        vertexPoints.emplace_back(static_cast<double>(vertex.point.x), static_cast<double>(vertex.point.y));
+    std::vector<FrozenDiagram::HalfEdge> halfEdges(nbHalfEdges);
+    for (const HalfEdge& halfEdge : mHalfEdges)
+    {
+        Index i = halfEdgeIndices[halfEdge.index];
+        halfEdges[i] = FrozenDiagram::HalfEdge{getVertexIndex(halfEdge.origin),
+            static_cast<Index>(halfEdge.incidentFace->site->index), getHalfEdgeIndex(halfEdge.prev), getHalfEdgeIndex(halfEdge.next)};
+        // Border half edge, its destination is stored in a twin without face
+        if (halfEdge.twin == nullptr)
+            halfEdges[FrozenDiagram::getTwin(i)] = FrozenDiagram::HalfEdge{getVertexIndex(halfEdge.destination),
+                FrozenDiagram::INVALID_INDEX, FrozenDiagram::INVALID_INDEX, FrozenDiagram::INVALID_INDEX};
+    }
+    return FrozenDiagram(std::move(sitePoints), std::move(outerComponents), std::move(vertexPoints), std::move(halfEdges));
+}
+
+template<typename T>
+std::size_t BasicVoronoiDiagram<T>::getMemoryUsage() const
+{
+    return mSites.capacity() * sizeof(Site) + mFaces.capacity() * sizeof(Face) +
+        mVertices.getCapacity() * sizeof(Vertex) + mHalfEdges.getCapacity() * sizeof(HalfEdge);
+}
+
+template<typename T>
+typename BasicVoronoiDiagram<T>::Vertex* BasicVoronoiDiagram<T>::createVertex(Vector2 point)
+{
+    Vertex* vertex;
+    if (!mFreeVertices.empty())
+    {
+        vertex = mFreeVertices.back();
+        mFreeVertices.pop_back();
+    }
+    else
+    {
+        vertex = mVertices.emplaceBack();
+        vertex->index = mVertices.getSize() - 1;
+    }
+    vertex->point = point;
+    mVertexBox.left = std::min(point.x, mVertexBox.left);
+    mVertexBox.bottom = std::min(point.y, mVertexBox.bottom);
+    mVertexBox.right = std::max(point.x, mVertexBox.right);
+    mVertexBox.top = std::max(point.y, mVertexBox.top);
+    return vertex;
 }
 
-VoronoiDiagram::Vertex* VoronoiDiagram::createVertex(Vector2 point)
+template<typename T>
+typename BasicVoronoiDiagram<T>::Vertex* BasicVoronoiDiagram<T>::createCorner(Box box, typename Box::Side side)
 {
-    mVertices.emplace_back();
-    mVertices.back().point = point;
-    mVertices.back().it = std::prev(mVertices.end());
-    return &mVertices.back();
+    return createVertex(getCorner(box, side));
 }
 
-VoronoiDiagram::Vertex* VoronoiDiagram::createCorner(Box box, Box::Side side)
+template<typename T>
+typename BasicVoronoiDiagram<T>::HalfEdge* BasicVoronoiDiagram<T>::createHalfEdge(Face* face)
+{
+    HalfEdge* halfEdge;
+    if (!mFreeHalfEdges.empty())
+    {
+        // The recycled half edges keep their slot
+        halfEdge = mFreeHalfEdges.back();
+        mFreeHalfEdges.pop_back();
+        halfEdge->origin = nullptr;
+        halfEdge->destination = nullptr;
+        halfEdge->twin = nullptr;
+        halfEdge->prev = nullptr;
+        halfEdge->next = nullptr;
+    }
+    else
+    {
+        halfEdge = mHalfEdges.emplaceBack();
+        halfEdge->index = mHalfEdges.getSize() - 1;
+    }
+    halfEdge->incidentFace = face;
+    if(face->outerComponent == nullptr)
+        face->outerComponent = halfEdge;
+    return halfEdge;
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::recycleVertex(Vertex* vertex)
+{
+    mFreeVertices.push_back(vertex);
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::recycleHalfEdge(HalfEdge* halfEdge)
+{
+    mFreeHalfEdges.push_back(halfEdge);
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::removeCells()
+{
+    mVertices.clear();
+    mHalfEdges.clear();
+    mFreeVertices.clear();
+    mFreeHalfEdges.clear();
+    mDirty = false;
+    for (Face& face : mFaces)
+        face.outerComponent = nullptr;
+}
+
+template<typename T>
+typename BasicVoronoiDiagram<T>::Vector2 BasicVoronoiDiagram<T>::getCorner(Box box, typename Box::Side side)
 {
     switch (side)
     {
         case Box::Side::LEFT:
-            return createVertex(Vector2(box.left, box.top));
+            return Vector2(box.left, box.top);
         case Box::Side::BOTTOM:
-            return createVertex(Vector2(box.left, box.bottom));
+            return Vector2(box.left, box.bottom);
         case Box::Side::RIGHT:
-            return createVertex(Vector2(box.right, box.bottom));
+            return Vector2(box.right, box.bottom);
         case Box::Side::TOP:
-            return createVertex(Vector2(box.right, box.top));
         default:
-            return nullptr;
+            return Vector2(box.right, box.top);
     }
 }
 
-VoronoiDiagram::HalfEdge* VoronoiDiagram::createHalfEdge(Face* face)
+template<typename T>
+void BasicVoronoiDiagram<T>::findCandidates(Box box, Face* face, CrossingCandidates& candidates)
 {
-    mHalfEdges.emplace_back();
-    mHalfEdges.back().incidentFace = face;
-    mHalfEdges.back().it = std::prev(mHalfEdges.end());
-    if(face->outerComponent == nullptr)
-        face->outerComponent = &mHalfEdges.back();
-    return &mHalfEdges.back();
+    HalfEdge* halfEdge = face->outerComponent;
+    bool inside = box.contains(halfEdge->origin->point);
+    do
+    {
+        bool nextInside = box.contains(halfEdge->destination->point);
+        if (!inside || !nextInside)
+        {
+            candidates.halfEdges.push_back(halfEdge);
+            candidates.originsInside.push_back(inside);
+            candidates.destinationsInside.push_back(nextInside);
+            candidates.origins.pushBack(halfEdge->origin->point);
+            candidates.destinations.pushBack(halfEdge->destination->point);
+        }
+        halfEdge = halfEdge->next;
+        inside = nextInside;
+    } while (halfEdge != face->outerComponent);
+}
+
+template<typename T>
+bool BasicVoronoiDiagram<T>::findCrossings(BorderFace& borderFace, const CrossingCandidates& candidates,
+    std::vector<Crossing>& crossings, std::vector<char>& crossingHalfEdges)
+{
+    bool valid = true;
+    std::size_t firstCrossing = crossings.size();
+    std::size_t nbIncomings = 0;
+    std::size_t nbOutgoings = 0;
+    for (std::size_t i = borderFace.firstCrossing; i < borderFace.lastCrossing; ++i)
+    {
+        HalfEdge* halfEdge = candidates.halfEdges[i];
+        bool inside = candidates.originsInside[i];
+        bool nextInside = candidates.destinationsInside[i];
+        int nbIntersections = candidates.nbIntersections[i];
+        Crossing crossing{halfEdge, halfEdge->origin, CrossingType::OUTSIDE, candidates.intersections[i]};
+        bool crossingValid = true;
+        // The two points are outside the box, the edge is either outside or crosses twice the frontiers of the box
+        if (!inside && !nextInside)
+        {
+            if (nbIntersections == 2)
+                crossing.type = CrossingType::THROUGH;
+            else if (nbIntersections != 0)
+                crossingValid = false;
+        }
+        else if (nbIntersections == 1)
+            crossing.type = inside ? CrossingType::OUTGOING : CrossingType::INCOMING;
+        else
+            crossingValid = false;
+        if (crossingValid)
+        {
+            crossings.push_back(crossing);
+            crossingHalfEdges[halfEdge->index] = crossing.type != CrossingType::OUTSIDE;
+            nbIncomings += crossing.type == CrossingType::INCOMING;
+            nbOutgoings += crossing.type == CrossingType::OUTGOING;
+        }
+        else
+            valid = false;
+    }
+    // The boundary of the face goes in the box as many times as it goes out
+    valid = valid && nbIncomings == nbOutgoings;
+    // From now on, the face refers to its crossings
+    borderFace.firstCrossing = firstCrossing;
+    borderFace.lastCrossing = crossings.size();
+    return valid;
 }
 
-void VoronoiDiagram::link(Box box, HalfEdge* start, Box::Side startSide, HalfEdge* end, Box::Side endSide)
+template<typename T>
+bool BasicVoronoiDiagram<T>::ownsIntersections(const HalfEdge* halfEdge,
+    const std::vector<char>& crossingHalfEdges) const
+{
+    // If both twins cross the box, the intersections belong to the face with the smallest index
+    const HalfEdge* twin = halfEdge->twin;
+    return twin == nullptr || !crossingHalfEdges[twin->index] ||
+        twin->incidentFace->site->index > halfEdge->incidentFace->site->index;
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::clipFace(Box box, BorderFace& borderFace, const std::vector<Crossing>& crossings,
+    const std::vector<char>& crossingHalfEdges, ClipPass pass, Vertex* const* vertices, HalfEdge* const* halfEdges)
+{
+    std::size_t nbVertices = 0;
+    std::size_t nbHalfEdges = 0;
+    HalfEdge* incomingHalfEdge = nullptr; // First half edge coming in the box
+    HalfEdge* outgoingHalfEdge = nullptr; // Last half edge going out the box
+    typename Box::Side incomingSide = Box::Side::LEFT;
+    typename Box::Side outgoingSide = Box::Side::LEFT;
+    auto linkAlongBox = [&](HalfEdge* start, typename Box::Side startSide, HalfEdge* end, typename Box::Side endSide)
+    {
+        if (pass == ClipPass::LINKS)
+            link(box, start, startSide, end, endSide, vertices + nbVertices, halfEdges + nbHalfEdges);
+        std::size_t nbCorners = (static_cast<int>(endSide) - static_cast<int>(startSide) + 4) % 4;
+        nbVertices += nbCorners;
+        nbHalfEdges += nbCorners + 1;
+    };
+    auto createIntersection = [&](Vertex*& vertex, const typename Box::Intersection& intersection)
+    {
+        if (pass == ClipPass::INTERSECTIONS)
+        {
+            vertex = vertices[nbVertices];
+            vertex->point = intersection.point;
+        }
+        ++nbVertices;
+    };
+    for (std::size_t i = borderFace.firstCrossing; i < borderFace.lastCrossing; ++i)
+    {
+        const Crossing& crossing = crossings[i];
+        HalfEdge* halfEdge = crossing.halfEdge;
+        if (crossing.type == CrossingType::OUTSIDE)
+            continue;
+        // The owner creates the intersections during the first pass, the twin reuses them during the second one
+        const typename Box::Intersection& outgoingIntersection =
+            crossing.intersections[crossing.type == CrossingType::THROUGH ? 1 : 0];
+        if (ownsIntersections(halfEdge, crossingHalfEdges))
+        {
+            if (crossing.type != CrossingType::OUTGOING)
+                createIntersection(halfEdge->origin, crossing.intersections[0]);
+            if (crossing.type != CrossingType::INCOMING)
+                createIntersection(halfEdge->destination, outgoingIntersection);
+        }
+        else if (pass == ClipPass::LINKS)
+        {
+            if (crossing.type != CrossingType::OUTGOING)
+                halfEdge->origin = halfEdge->twin->destination;
+            if (crossing.type != CrossingType::INCOMING)
+                halfEdge->destination = halfEdge->twin->origin;
+        }
+        // Link with the previous half edge going out the box
+        if (crossing.type != CrossingType::OUTGOING)
+        {
+            typename Box::Side side = box.getBorderSide(crossing.intersections[0].point,
+                crossing.intersections[0].side, true);
+            if (outgoingHalfEdge != nullptr)
+                linkAlongBox(outgoingHalfEdge, outgoingSide, halfEdge, side);
+            if (incomingHalfEdge == nullptr)
+            {
+                incomingHalfEdge = halfEdge;
+                incomingSide = side;
+            }
+        }
+        if (crossing.type != CrossingType::INCOMING)
+        {
+            outgoingHalfEdge = halfEdge;
+            outgoingSide = box.getBorderSide(outgoingIntersection.point, outgoingIntersection.side, false);
+        }
+    }
+    // Link the last and the first half edges inside the box
+    if (borderFace.outerComponentDirty && incomingHalfEdge != nullptr && outgoingHalfEdge != nullptr)
+        linkAlongBox(outgoingHalfEdge, outgoingSide, incomingHalfEdge, incomingSide);
+    if (pass == ClipPass::COUNT)
+    {
+        borderFace.nbVertices = nbVertices;
+        borderFace.nbHalfEdges = nbHalfEdges;
+    }
+    // Set outer component
+    else if (pass == ClipPass::LINKS && borderFace.outerComponentDirty)
+        borderFace.face->outerComponent = incomingHalfEdge;
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::link(Box box, HalfEdge* start, typename Box::Side startSide, HalfEdge* end,
+    typename Box::Side endSide, Vertex* const* corners, HalfEdge* const* halfEdges)
 {
     HalfEdge* halfEdge = start;
     int side = static_cast<int>(startSide);
     while (side != static_cast<int>(endSide))
     {
         side = (side + 1) % 4;
-        halfEdge->next = createHalfEdge(start->incidentFace);
+        halfEdge->next = *halfEdges++;
+        halfEdge->next->incidentFace = start->incidentFace;
         halfEdge->next->prev = halfEdge;
         halfEdge->next->origin = halfEdge->destination;
-        halfEdge->next->destination = createCorner(box, static_cast<Box::Side>(side));
+        (*corners)->point = getCorner(box, static_cast<typename Box::Side>(side));
+        halfEdge->next->destination = *corners++;
         halfEdge = halfEdge->next;
     }
-    halfEdge->next = createHalfEdge(start->incidentFace);
+    halfEdge->next = *halfEdges;
+    halfEdge->next->incidentFace = start->incidentFace;
     halfEdge->next->prev = halfEdge;
     end->prev = halfEdge->next;
     halfEdge->next->next = end;
@@ -224,13 +536,91 @@ void VoronoiDiagram::link(Box box, HalfEdge* start, Box::Side startSide, HalfEdg
     halfEdge->next->destination = end->origin;
 }
 
-void VoronoiDiagram::removeVertex(Vertex* vertex)
+template<typename T>
+void BasicVoronoiDiagram<T>::removeVertex(Vertex* vertex)
+{
+    vertex->index = REMOVED;
+    mDirty = true;
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::removeHalfEdge(HalfEdge* halfEdge)
+{
+    halfEdge->index = REMOVED;
+    mDirty = true;
+}
+
+template<typename T>
+void BasicVoronoiDiagram<T>::compact()
+{
+    if (!mDirty)
+        return;
+    // Compute the new indices
+    std::size_t nbVertices = 0;
+    for (Vertex& vertex : mVertices)
+    {
+        if (vertex.index != REMOVED)
+            vertex.index = nbVertices++;
+    }
+    std::size_t nbHalfEdges = 0;
+    for (HalfEdge& halfEdge : mHalfEdges)
+    {
+        if (halfEdge.index != REMOVED)
+            halfEdge.index = nbHalfEdges++;
+    }
+    // Update the pointers before moving the elements
+    for (HalfEdge& halfEdge : mHalfEdges)
+    {
+        if (halfEdge.index == REMOVED)
+            continue;
+        halfEdge.origin = getNewAddress(halfEdge.origin);
+        halfEdge.destination = getNewAddress(halfEdge.destination);
+        halfEdge.twin = getNewAddress(halfEdge.twin);
+        halfEdge.prev = getNewAddress(halfEdge.prev);
+        halfEdge.next = getNewAddress(halfEdge.next);
+    }
+    for (Face& face : mFaces)
+        face.outerComponent = getNewAddress(face.outerComponent);
+    // Move the elements, they can only go backward
+    auto itVertex = mVertices.begin();
+    for (Vertex& vertex : mVertices)
+    {
+        if (vertex.index != REMOVED)
+        {
+            *itVertex = vertex;
+            ++itVertex;
+        }
+    }
+    mVertices.truncate(nbVertices);
+    auto itHalfEdge = mHalfEdges.begin();
+    for (HalfEdge& halfEdge : mHalfEdges)
+    {
+        if (halfEdge.index != REMOVED)
+        {
+            *itHalfEdge = halfEdge;
+            ++itHalfEdge;
+        }
+    }
+    mHalfEdges.truncate(nbHalfEdges);
+    mDirty = false;
+}
+
+template<typename T>
+typename BasicVoronoiDiagram<T>::Vertex* BasicVoronoiDiagram<T>::getNewAddress(Vertex* vertex)
 {
-    mVertices.erase(vertex->it);
+    if (vertex == nullptr || vertex->index == REMOVED)
+        return nullptr;
+    return &mVertices[vertex->index];
 }
 
-void VoronoiDiagram::removeHalfEdge(HalfEdge* halfEdge)
+template<typename T>
+typename BasicVoronoiDiagram<T>::HalfEdge* BasicVoronoiDiagram<T>::getNewAddress(HalfEdge* halfEdge)
 {
-    mHalfEdges.erase(halfEdge->it);
+    if (halfEdge == nullptr || halfEdge->index == REMOVED)
+        return nullptr;
+    return &mHalfEdges[halfEdge->index];
 }
 
+template class BasicVoronoiDiagram<float>;
+template class BasicVoronoiDiagram<double>;
+template class BasicVoronoiDiagram<long double>;
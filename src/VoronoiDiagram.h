@@ -18,16 +18,29 @@
 #pragma once
 
 // STL
+#include <array>
 #include <vector>
-#include <list>
 // My includes
 #include "Box.h"
+#include "PointView.h"
+#include "StableVector.h"
+#include "FrozenDiagram.h"
 
-class FortuneAlgorithm;
+template<typename B, typename Q>
+class BasicFortuneAlgorithm;
+class ParallelFortuneAlgorithm;
 
-class VoronoiDiagram
+// T is the scalar type of the coordinates: float, double or long double
+template<typename T>
+class BasicVoronoiDiagram
 {
 public:
+    using Scalar = T;
+    using Vector2 = BasicVector2<T>;
+    using Vector2Array = BasicVector2Array<T>;
+    using Box = BasicBox<T>;
+    using PointView = BasicPointView<T>;
+
     struct HalfEdge;
     struct Face;
 
@@ -43,8 +56,11 @@ public:
         Vector2 point;
 
     private:
-        friend VoronoiDiagram;
-        std::list<Vertex>::iterator it;
+        friend BasicVoronoiDiagram;
+        template<typename B, typename Q>
+        friend class BasicFortuneAlgorithm;
+        friend ParallelFortuneAlgorithm;
+        std::size_t index;
     };
 
     struct HalfEdge
@@ -57,8 +73,11 @@ public:
         HalfEdge* next = nullptr;
 
     private:
-        friend VoronoiDiagram;
-        std::list<HalfEdge>::iterator it;
+        friend BasicVoronoiDiagram;
+        template<typename B, typename Q>
+        friend class BasicFortuneAlgorithm;
+        friend ParallelFortuneAlgorithm;
+        std::size_t index;
     };
 
     struct Face
@@ -67,41 +86,123 @@ public:
         HalfEdge* outerComponent;
     };
 
-    VoronoiDiagram(const std::vector<Vector2>& points);
+    // The coordinates are copied in the sites, the points are not used afterwards
+    BasicVoronoiDiagram(PointView points);
 
     // Remove copy operations
-    VoronoiDiagram(const VoronoiDiagram&) = delete;
-    VoronoiDiagram& operator=(const VoronoiDiagram&) = delete;
+    BasicVoronoiDiagram(const BasicVoronoiDiagram&) = delete;
+    BasicVoronoiDiagram& operator=(const BasicVoronoiDiagram&) = delete;
 
     // Move operations
-    VoronoiDiagram(VoronoiDiagram&&) = default;
-    VoronoiDiagram& operator=(VoronoiDiagram&&) = default;
+    BasicVoronoiDiagram(BasicVoronoiDiagram&&) = default;
+    BasicVoronoiDiagram& operator=(BasicVoronoiDiagram&&) = default;
+
+    // Replace the sites and remove all the vertices and half edges but keep the memory
+    void reset(PointView points);
 
     // Accessors
     Site* getSite(std::size_t i);
+    const Site* getSite(std::size_t i) const;
     std::size_t getNbSites() const;
     Face* getFace(std::size_t i);
-    const std::list<Vertex>& getVertices() const;
-    const std::list<HalfEdge>& getHalfEdges() const;
+    const StableVector<Vertex>& getVertices() const;
+    const StableVector<HalfEdge>& getHalfEdges() const;
 
     // Intersection with a box
-    bool intersect(Box box);
+    // nbThreads = 0 means one thread per hardware core, small diagrams are clipped on the current thread
+    // The remaining vertices and half edges are compacted: the pointers to them held before the call are invalidated
+    // and their indices change, only the sites and the faces do not move
+    bool intersect(Box box, std::size_t nbThreads = 0);
+
+    // Conversion to an immutable index-based diagram, its coordinates are always doubles
+    FrozenDiagram freeze() const;
+
+    // Memory
+    std::size_t getMemoryUsage() const;
 
 private:
     std::vector<Site> mSites;
     std::vector<Face> mFaces;
-    std::list<Vertex> mVertices;
-    std::list<HalfEdge> mHalfEdges;
+    StableVector<Vertex> mVertices;
+    StableVector<HalfEdge> mHalfEdges;
+    bool mDirty; // Some vertices or half edges are removed
+    Box mVertexBox; // Contains all the vertices created since the last reset
+    // Elements of the cells emitted by a streaming construction, they are reused before growing the storage
+    std::vector<Vertex*> mFreeVertices;
+    std::vector<HalfEdge*> mFreeHalfEdges;
 
     // Diagram construction
-    friend FortuneAlgorithm;
+    template<typename B, typename Q>
+    friend class BasicFortuneAlgorithm;
+    friend ParallelFortuneAlgorithm;
 
     Vertex* createVertex(Vector2 point);
-    Vertex* createCorner(Box box, Box::Side side);
+    Vertex* createCorner(Box box, typename Box::Side side);
     HalfEdge* createHalfEdge(Face* face);
+    void recycleVertex(Vertex* vertex);
+    void recycleHalfEdge(HalfEdge* halfEdge);
+    void removeCells(); // Keep only the sites
 
     // Intersection with a box
-    void link(Box box, HalfEdge* start, Box::Side startSide, HalfEdge* end, Box::Side endSide);
+    enum class CrossingType{OUTSIDE, THROUGH, OUTGOING, INCOMING};
+    enum class ClipPass{COUNT, INTERSECTIONS, LINKS};
+
+    // Half edge of a face with at least one end outside the box
+    struct Crossing
+    {
+        HalfEdge* halfEdge;
+        Vertex* origin; // Origin before the clipping
+        CrossingType type;
+        std::array<typename Box::Intersection, 2> intersections;
+    };
+
+    // Half edges with an end outside the box, their intersections with the box are computed at once
+    struct CrossingCandidates
+    {
+        std::vector<HalfEdge*> halfEdges;
+        std::vector<char> originsInside;
+        std::vector<char> destinationsInside;
+        Vector2Array origins;
+        Vector2Array destinations;
+        std::vector<int> nbIntersections;
+        std::vector<std::array<typename Box::Intersection, 2>> intersections;
+    };
+
+    // Face with at least one vertex outside the box, its candidates then its crossings are stored contiguously
+    struct BorderFace
+    {
+        Face* face;
+        bool outerComponentDirty;
+        std::size_t firstCrossing;
+        std::size_t lastCrossing;
+        std::size_t nbVertices; // Intersections owned by the face and corners
+        std::size_t nbHalfEdges;
+        std::size_t firstVertex;
+        std::size_t firstHalfEdge;
+    };
+
+    static Vector2 getCorner(Box box, typename Box::Side side);
+    void findCandidates(Box box, Face* face, CrossingCandidates& candidates);
+    bool findCrossings(BorderFace& borderFace, const CrossingCandidates& candidates, std::vector<Crossing>& crossings,
+        std::vector<char>& crossingHalfEdges);
+    bool ownsIntersections(const HalfEdge* halfEdge, const std::vector<char>& crossingHalfEdges) const;
+    void clipFace(Box box, BorderFace& borderFace, const std::vector<Crossing>& crossings,
+        const std::vector<char>& crossingHalfEdges, ClipPass pass, Vertex* const* vertices, HalfEdge* const* halfEdges);
+    void link(Box box, HalfEdge* start, typename Box::Side startSide, HalfEdge* end, typename Box::Side endSide,
+        Vertex* const* corners, HalfEdge* const* halfEdges);
     void removeVertex(Vertex* vertex);
     void removeHalfEdge(HalfEdge* halfEdge);
+
+    // Storage
+    static constexpr std::size_t REMOVED = static_cast<std::size_t>(-1);
+
+    void compact();
+    Vertex* getNewAddress(Vertex* vertex);
+    HalfEdge* getNewAddress(HalfEdge* halfEdge);
 };
+
+extern template class BasicVoronoiDiagram<float>;
+extern template class BasicVoronoiDiagram<double>;
+extern template class BasicVoronoiDiagram<long double>;
+
+using VoronoiDiagram = BasicVoronoiDiagram<double>;
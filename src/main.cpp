@@ -100,32 +100,33 @@ void drawDiagram(sf::RenderWindow& window, VoronoiDiagram& diagram)
     }
 }
 
-VoronoiDiagram generateRandomDiagram(std::size_t nbPoints)
+VoronoiDiagram generateRandomDiagram(FortuneAlgorithm& algorithm, std::size_t nbPoints, VoronoiDiagram previousDiagram)
 {
     // Generate points
     std::vector<Vector2> points = generatePoints(nbPoints);
 
-    // Construct diagram
-    FortuneAlgorithm algorithm(points);
+    // Construct diagram, the memory of the previous one is reused
+    algorithm.reset(points, std::move(previousDiagram));
     auto start = std::chrono::steady_clock::now();
-    algorithm.construct();
+    algorithm.construct(FortuneAlgorithm::SiteEventMode::SORTED);
     auto duration = std::chrono::steady_clock::now() - start;
     std::cout << "construction: " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms" << '\n';
+    std::cout << "  sorting: " << std::chrono::duration_cast<std::chrono::milliseconds>(algorithm.getTimings().initialization).count() << "ms" << '\n';
+    std::cout << "  sweep: " << std::chrono::duration_cast<std::chrono::milliseconds>(algorithm.getTimings().sweep).count() << "ms" << '\n';
 
-    // Bound the diagram
+    // Bound the diagram and intersect it with a box
     start = std::chrono::steady_clock::now();
-    algorithm.bound(Box{-0.05, -0.05, 1.05, 1.05}); // Take the bounding box slightly bigger than the intersection box
+    bool valid = algorithm.finalize(Box{0.0, 0.0, 1.0, 1.0});
     duration = std::chrono::steady_clock::now() - start;
-    std::cout << "bounding: " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms" << '\n';
-    VoronoiDiagram diagram = algorithm.getDiagram();
-
-    // Intersect the diagram with a box
-    start = std::chrono::steady_clock::now();
-    bool valid = diagram.intersect(Box{0.0, 0.0, 1.0, 1.0});
-    duration = std::chrono::steady_clock::now() - start;
-    std::cout << "intersection: " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms" << '\n';
+    std::cout << "finalization: " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms" << '\n';
     if (!valid)
         throw std::runtime_error("An error occured in the box intersection algorithm");
+    VoronoiDiagram diagram = algorithm.getDiagram();
+
+    // Memory footprint
+    FrozenDiagram frozenDiagram = diagram.freeze();
+    std::cout << "memory: " << diagram.getMemoryUsage() / nbPoints << " bytes per site, " <<
+        frozenDiagram.getMemoryUsage() / nbPoints << " bytes per site when frozen" << '\n';
 
     return diagram;
 }
@@ -133,7 +134,8 @@ VoronoiDiagram generateRandomDiagram(std::size_t nbPoints)
 int main()
 {
     std::size_t nbPoints = 100;
-    VoronoiDiagram diagram = generateRandomDiagram(nbPoints);
+    FortuneAlgorithm algorithm(std::vector<Vector2>{});
+    VoronoiDiagram diagram = generateRandomDiagram(algorithm, nbPoints, algorithm.getDiagram());
 
     // Display the diagram
     sf::ContextSettings settings;
@@ -149,7 +151,7 @@ int main()
             if (event.type == sf::Event::Closed)
                 window.close();
             else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::N)
-                diagram = generateRandomDiagram(nbPoints);
+                diagram = generateRandomDiagram(algorithm, nbPoints, std::move(diagram));
         }
 
         window.clear(sf::Color::Black);
@@ -0,0 +1,143 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// STL
+#include <algorithm>
+#include <functional>
+#include <vector>
+// My includes
+#include "Tests.h"
+
+namespace
+{
+
+using SiteEventMode = FortuneAlgorithmBase::SiteEventMode;
+using LocationMode = FortuneAlgorithmBase::LocationMode;
+using PredicateMode = FortuneAlgorithmBase::PredicateMode;
+
+// Point set with the boxes and the predicates it is tested with
+struct Input
+{
+    std::string name;
+    std::vector<Vector2> points;
+    Box boundingBox;
+    Box box;
+    PredicateMode predicateMode;
+};
+
+std::vector<Input> getInputs()
+{
+    std::vector<Input> inputs;
+    for (std::uint64_t seed : SEEDS)
+    {
+        inputs.push_back(Input{"uniform " + std::to_string(seed), generateUniformPoints(NB_UNIFORM_POINTS, seed),
+            BOUNDING_BOX, BOX, PredicateMode::FLOATING});
+        inputs.push_back(Input{"integer " + std::to_string(seed), generateIntegerPoints(NB_INTEGER_POINTS, seed),
+            INTEGER_BOUNDING_BOX, INTEGER_BOX, PredicateMode::INTEGER});
+    }
+    for (PredicateMode predicateMode : {PredicateMode::FLOATING, PredicateMode::INTEGER})
+        inputs.push_back(Input{"duplicates", getDuplicateSitePoints(), DUPLICATE_BOUNDING_BOX, DUPLICATE_BOX,
+            predicateMode});
+    return inputs;
+}
+
+// Run test for every input and every combination of modes
+void forEachConfiguration(const std::function<void(const Input&, SiteEventMode, LocationMode,
+    const std::string&)>& test)
+{
+    for (const Input& input : getInputs())
+    {
+        for (SiteEventMode mode : {SiteEventMode::HEAP, SiteEventMode::SORTED})
+        {
+            for (LocationMode locationMode : {LocationMode::ROOT, LocationMode::HINT})
+                test(input, mode, locationMode, input.name + " " + getName(mode) + " " + getName(locationMode) + " " +
+                    getName(input.predicateMode));
+        }
+    }
+}
+
+// Construction, bounding and intersection, the two-pass sequence replaced by finalize and stream
+AreaMap computeTwoPassAreas(const Input& input, SiteEventMode mode, LocationMode locationMode,
+    const std::string& message)
+{
+    FortuneAlgorithm algorithm(input.points);
+    algorithm.construct(mode, locationMode, input.predicateMode);
+    bool valid = algorithm.bound(input.boundingBox);
+    VoronoiDiagram diagram = algorithm.getDiagram();
+    valid = diagram.intersect(input.box) && valid;
+    check(valid, message + " two passes is valid");
+    return computeAreas(diagram);
+}
+
+double getArea(Box box)
+{
+    return (box.right - box.left) * (box.top - box.bottom);
+}
+
+}
+
+void runFinalizeTests()
+{
+    forEachConfiguration([](const Input& input, SiteEventMode mode, LocationMode locationMode,
+        const std::string& message)
+    {
+        AreaMap expectedAreas = computeTwoPassAreas(input, mode, locationMode, message);
+        FortuneAlgorithm algorithm(input.points);
+        algorithm.construct(mode, locationMode, input.predicateMode);
+        bool valid = algorithm.finalize(input.box);
+        VoronoiDiagram diagram = algorithm.getDiagram();
+        check(valid, message + " finalize is valid");
+        AreaMap areas = computeAreas(diagram);
+        double area = getArea(input.box);
+        check(std::abs(getTotalArea(areas) - area) <= 1e-9 * area, message + " finalize covers the box");
+        check(haveSameAreas(areas, expectedAreas, 1e-9 * area), message + " finalize matches the two passes");
+        // The sites are in the box, each point has exactly one cell even if it is duplicated
+        check(countCells(diagram) == areas.size(), message + " finalize has one cell per point");
+    });
+}
+
+void runStreamTests()
+{
+    forEachConfiguration([](const Input& input, SiteEventMode mode, LocationMode locationMode,
+        const std::string& message)
+    {
+        AreaMap expectedAreas = computeTwoPassAreas(input, mode, locationMode, message);
+        std::vector<std::size_t> nbEmissions(input.points.size(), 0);
+        std::size_t nbCells = 0;
+        bool inRange = true;
+        AreaMap areas;
+        FortuneAlgorithm algorithm(input.points);
+        bool valid = algorithm.stream(input.box, [&](const FortuneAlgorithm::Cell& cell)
+        {
+            if (cell.site >= input.points.size())
+            {
+                inRange = false;
+                return;
+            }
+            ++nbEmissions[cell.site];
+            nbCells += !cell.vertices.empty();
+            const Vector2& point = input.points[cell.site];
+            areas[std::make_pair(point.x, point.y)] += computeArea(cell.vertices);
+        }, mode, locationMode, input.predicateMode);
+        check(valid, message + " stream is valid");
+        check(inRange && std::all_of(nbEmissions.begin(), nbEmissions.end(), [](std::size_t n){ return n == 1; }),
+            message + " stream gives each site once");
+        double area = getArea(input.box);
+        check(haveSameAreas(areas, expectedAreas, 1e-9 * area), message + " stream matches the two passes");
+        check(nbCells == areas.size(), message + " stream has one cell per point");
+    });
+}
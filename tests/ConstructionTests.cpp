@@ -0,0 +1,116 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// STL
+#include <vector>
+// My includes
+#include "Tests.h"
+
+namespace
+{
+
+using SiteEventMode = FortuneAlgorithmBase::SiteEventMode;
+using LocationMode = FortuneAlgorithmBase::LocationMode;
+using PredicateMode = FortuneAlgorithmBase::PredicateMode;
+
+// Same pipeline with the other beachlines and queues
+template<typename B, typename Q>
+void checkConstruction(const std::string& name, const std::vector<Vector2>& points, Box boundingBox, Box box,
+    PredicateMode predicateMode, const AreaMap& expectedAreas)
+{
+    double area = (box.right - box.left) * (box.top - box.bottom);
+    for (SiteEventMode mode : {SiteEventMode::HEAP, SiteEventMode::SORTED})
+    {
+        for (LocationMode locationMode : {LocationMode::ROOT, LocationMode::HINT})
+        {
+            std::string message = name + " " + getName(mode) + " " + getName(locationMode) + " " +
+                getName(predicateMode);
+            BasicFortuneAlgorithm<B, Q> algorithm(points);
+            algorithm.construct(mode, locationMode, predicateMode);
+            bool valid = algorithm.bound(boundingBox);
+            VoronoiDiagram diagram = algorithm.getDiagram();
+            valid = diagram.intersect(box) && valid;
+            check(valid, message + " is valid");
+            AreaMap areas = computeAreas(diagram);
+            check(std::abs(getTotalArea(areas) - area) <= 1e-9 * area, message + " covers the box");
+            check(haveSameAreas(areas, expectedAreas, 1e-9 * area), message + " matches the baseline");
+            // The sites are in the box, each point has exactly one cell even if it is duplicated
+            check(countCells(diagram) == areas.size(), message + " has one cell per point");
+        }
+    }
+}
+
+template<typename B, typename Q>
+void checkConstructions(const std::string& name)
+{
+    for (std::uint64_t seed : SEEDS)
+    {
+        std::vector<Vector2> points = generateUniformPoints(NB_UNIFORM_POINTS, seed);
+        AreaMap expectedAreas = computeBaselineAreas(points, BOUNDING_BOX, BOX);
+        checkConstruction<B, Q>(name, points, BOUNDING_BOX, BOX, PredicateMode::FLOATING, expectedAreas);
+        // The floating predicates give no guarantee on the coarse grid
+        std::vector<Vector2> integerPoints = generateIntegerPoints(NB_INTEGER_POINTS, seed);
+        AreaMap expectedIntegerAreas = computeBaselineAreas(integerPoints, INTEGER_BOUNDING_BOX, INTEGER_BOX,
+            PredicateMode::INTEGER);
+        checkConstruction<B, Q>(name, integerPoints, INTEGER_BOUNDING_BOX, INTEGER_BOX, PredicateMode::INTEGER,
+            expectedIntegerAreas);
+    }
+    // Only the first of the coincident sites has a cell
+    std::vector<Vector2> points = getDuplicateSitePoints();
+    for (PredicateMode predicateMode : {PredicateMode::FLOATING, PredicateMode::INTEGER})
+    {
+        AreaMap expectedAreas = computeBaselineAreas(points, DUPLICATE_BOUNDING_BOX, DUPLICATE_BOX, predicateMode);
+        checkConstruction<B, Q>(name + " duplicates", points, DUPLICATE_BOUNDING_BOX, DUPLICATE_BOX, predicateMode,
+            expectedAreas);
+    }
+}
+
+// Single and extended precisions, the cells must close and cover the box up to the precision of the scalar
+template<typename T>
+void checkPrecision(const std::string& name, double tolerance)
+{
+    for (std::uint64_t seed : SEEDS)
+    {
+        std::vector<Vector2> points = generateUniformPoints(NB_UNIFORM_POINTS, seed);
+        std::vector<BasicVector2<T>> scalarPoints;
+        for (const Vector2& point : points)
+            scalarPoints.emplace_back(static_cast<T>(point.x), static_cast<T>(point.y));
+        BasicFortuneAlgorithm<BasicDefaultBeachline<T>, BasicEventQueue<T>> algorithm(scalarPoints);
+        algorithm.construct();
+        bool valid = algorithm.bound(BasicBox<T>{T(-0.05), T(-0.05), T(1.05), T(1.05)});
+        BasicVoronoiDiagram<T> diagram = algorithm.getDiagram();
+        valid = diagram.intersect(BasicBox<T>{T(0.0), T(0.0), T(1.0), T(1.0)}) && valid;
+        check(valid, name + " is valid");
+        check(std::abs(getTotalArea(computeAreas(diagram)) - 1.0) <= tolerance, name + " covers the box");
+    }
+}
+
+}
+
+void runConstructionTests()
+{
+    checkConstructions<Beachline, EventQueue>("Beachline EventQueue");
+    checkConstructions<Beachline, HeapEventQueue>("Beachline HeapEventQueue");
+    checkConstructions<BTreeBeachline, EventQueue>("BTreeBeachline EventQueue");
+    checkConstructions<BTreeBeachline, HeapEventQueue>("BTreeBeachline HeapEventQueue");
+}
+
+void runPrecisionTests()
+{
+    checkPrecision<float>("float", 1e-3);
+    checkPrecision<long double>("long double", 1e-9);
+}
@@ -0,0 +1,63 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// STL
+#include <vector>
+// My includes
+#include "Tests.h"
+#include "ParallelFortuneAlgorithm.h"
+#include "BatchFortuneAlgorithm.h"
+
+void runParallelTests()
+{
+    for (std::uint64_t seed : SEEDS)
+    {
+        std::vector<Vector2> points = generateUniformPoints(NB_UNIFORM_POINTS, seed);
+        AreaMap expectedAreas = computeBaselineAreas(points, BOUNDING_BOX, BOX);
+        // The slabs are stitched along the seams, the cells must not depend on the number of threads
+        for (std::size_t nbThreads : {1, 4})
+        {
+            std::string message = "parallel " + std::to_string(nbThreads) + " threads";
+            ParallelFortuneAlgorithm algorithm(points, nbThreads);
+            bool valid = algorithm.construct(BOX);
+            VoronoiDiagram diagram = algorithm.getDiagram();
+            check(valid, message + " is valid");
+            check(haveSameAreas(computeAreas(diagram), expectedAreas, 1e-9), message + " matches the baseline");
+        }
+    }
+}
+
+void runBatchTests()
+{
+    // Point sets with their own boxes, more sets than threads
+    std::vector<std::vector<Vector2>> pointSets;
+    std::vector<Box> boxes;
+    for (std::uint64_t seed : SEEDS)
+    {
+        pointSets.push_back(generateUniformPoints(NB_UNIFORM_POINTS / 10, seed));
+        boxes.push_back(BOX);
+    }
+    BatchFortuneAlgorithm algorithm(2);
+    std::vector<VoronoiDiagram> diagrams = algorithm.construct(pointSets, boxes);
+    check(diagrams.size() == pointSets.size() && algorithm.getNbInvalidDiagrams() == 0, "batch is valid");
+    for (std::size_t i = 0; i < diagrams.size(); ++i)
+    {
+        AreaMap expectedAreas = computeBaselineAreas(pointSets[i], BOUNDING_BOX, BOX);
+        check(haveSameAreas(computeAreas(diagrams[i]), expectedAreas, 1e-9),
+            "batch " + std::to_string(i) + " matches the baseline");
+    }
+}
@@ -0,0 +1,181 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// STL
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+// My includes
+#include "Tests.h"
+#include "DiagramCodec.h"
+
+namespace
+{
+
+using Cycle = std::vector<Vector2>;
+
+const std::string DIAGRAM_PATH = "FortuneTests.diagram";
+
+FrozenDiagram computeDiagram(const std::vector<Vector2>& points, Box box)
+{
+    FortuneAlgorithm algorithm(points);
+    algorithm.construct();
+    check(algorithm.finalize(box), "serialized diagram is valid");
+    return algorithm.getDiagram().freeze();
+}
+
+// Vertices of each face starting from the lowest one, so that the cycles do not depend on the half edge indices
+// A cycle is empty if the face has no outer component or is not closed
+std::vector<Cycle> getCycles(const FrozenDiagram& diagram)
+{
+    auto isBelow = [](const Vector2& lhs, const Vector2& rhs)
+    {
+        return lhs.y < rhs.y || (lhs.y == rhs.y && lhs.x < rhs.x);
+    };
+    std::vector<Cycle> cycles(diagram.getNbSites());
+    for (std::size_t i = 0; i < diagram.getNbSites(); ++i)
+    {
+        FrozenDiagram::Index start = diagram.getOuterComponent(i);
+        if (start == FrozenDiagram::INVALID_INDEX)
+            continue;
+        Cycle& cycle = cycles[i];
+        FrozenDiagram::Index halfEdge = start;
+        do
+        {
+            FrozenDiagram::Index origin = diagram.getOrigin(halfEdge);
+            if (origin == FrozenDiagram::INVALID_INDEX || cycle.size() > diagram.getNbHalfEdges())
+            {
+                cycle.clear();
+                break;
+            }
+            cycle.push_back(diagram.getVertexPoint(origin));
+            halfEdge = diagram.getNext(halfEdge);
+        } while (halfEdge != start && halfEdge != FrozenDiagram::INVALID_INDEX);
+        std::rotate(cycle.begin(), std::min_element(cycle.begin(), cycle.end(), isBelow), cycle.end());
+    }
+    return cycles;
+}
+
+// Same sites and same faces, the vertices being at most tolerance apart
+bool areSimilar(const FrozenDiagram& diagram, const FrozenDiagram& expectedDiagram, double tolerance)
+{
+    if (diagram.getNbSites() != expectedDiagram.getNbSites())
+        return false;
+    for (std::size_t i = 0; i < diagram.getNbSites(); ++i)
+    {
+        Vector2 point = diagram.getSitePoint(i);
+        Vector2 expectedPoint = expectedDiagram.getSitePoint(i);
+        if (point.x != expectedPoint.x || point.y != expectedPoint.y)
+            return false;
+    }
+    std::vector<Cycle> cycles = getCycles(diagram);
+    std::vector<Cycle> expectedCycles = getCycles(expectedDiagram);
+    for (std::size_t i = 0; i < cycles.size(); ++i)
+    {
+        if (cycles[i].size() != expectedCycles[i].size())
+            return false;
+        if (tolerance == 0.0)
+        {
+            for (std::size_t j = 0; j < cycles[i].size(); ++j)
+            {
+                if (cycles[i][j].x != expectedCycles[i][j].x || cycles[i][j].y != expectedCycles[i][j].y)
+                    return false;
+            }
+        }
+        else
+        {
+            // The quantization can change the lowest vertex, only the closeness of the areas is checked then
+            double perimeter = 0.0;
+            for (std::size_t j = 0; j < expectedCycles[i].size(); ++j)
+            {
+                const Vector2& point = expectedCycles[i][j];
+                const Vector2& nextPoint = expectedCycles[i][(j + 1) % expectedCycles[i].size()];
+                perimeter += std::abs(nextPoint.x - point.x) + std::abs(nextPoint.y - point.y);
+            }
+            if (!(std::abs(computeArea(cycles[i]) - computeArea(expectedCycles[i])) <= 2.0 * tolerance * perimeter))
+                return false;
+        }
+    }
+    return true;
+}
+
+void checkSaveAndLoad(const std::string& name, const FrozenDiagram& diagram)
+{
+    diagram.save(DIAGRAM_PATH);
+    {
+        FrozenDiagram loadedDiagram = FrozenDiagram::load(DIAGRAM_PATH);
+        check(loadedDiagram.getNbVertices() == diagram.getNbVertices() &&
+            loadedDiagram.getNbHalfEdges() == diagram.getNbHalfEdges(), name + " loaded sizes");
+        check(areSimilar(loadedDiagram, diagram, 0.0), name + " loaded diagram is identical");
+    }
+    std::remove(DIAGRAM_PATH.c_str());
+}
+
+void checkCodec(const std::string& name, const FrozenDiagram& diagram, Box box)
+{
+    for (int nbBits : {0, 16})
+    {
+        std::string message = name + " " + std::to_string(nbBits) + " bits";
+        std::stringstream stream;
+        std::size_t nbBytes = encodeDiagram(diagram, stream, nbBits, box);
+        std::string data = stream.str();
+        check(nbBytes == data.size(), message + " gives the number of written bytes");
+        FrozenDiagram decodedDiagram = decodeDiagram(stream);
+        // The quantization error is at most half a step on each coordinate
+        double step = std::max(box.right - box.left, box.top - box.bottom) / (1 << 16);
+        check(areSimilar(decodedDiagram, diagram, nbBits == 0 ? 0.0 : step), message + " decoded diagram matches");
+        // A truncated stream is detected
+        std::stringstream truncatedStream(data.substr(0, data.size() / 2));
+        bool thrown = false;
+        try
+        {
+            decodeDiagram(truncatedStream);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        check(thrown, message + " truncated stream throws");
+    }
+}
+
+}
+
+void runSaveTests()
+{
+    for (std::uint64_t seed : SEEDS)
+    {
+        FrozenDiagram diagram = computeDiagram(generateUniformPoints(NB_UNIFORM_POINTS, seed), BOX);
+        checkSaveAndLoad("uniform " + std::to_string(seed), diagram);
+    }
+    // The faces of the duplicate sites are empty
+    FrozenDiagram diagram = computeDiagram(getDuplicateSitePoints(), DUPLICATE_BOX);
+    checkSaveAndLoad("duplicates", diagram);
+}
+
+void runEncodingTests()
+{
+    for (std::uint64_t seed : SEEDS)
+    {
+        FrozenDiagram diagram = computeDiagram(generateUniformPoints(NB_UNIFORM_POINTS, seed), BOX);
+        checkCodec("uniform " + std::to_string(seed), diagram, BOX);
+    }
+    // The empty faces of the duplicate sites are encoded too
+    checkCodec("duplicates", computeDiagram(getDuplicateSitePoints(), DUPLICATE_BOX), DUPLICATE_BOX);
+}
@@ -0,0 +1,138 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Tests.h"
+// STL
+#include <iostream>
+#include <random>
+
+namespace
+{
+
+std::size_t nbFailures = 0;
+
+}
+
+void check(bool condition, const std::string& message)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED: " << message << std::endl;
+        ++nbFailures;
+    }
+}
+
+std::size_t getNbFailures()
+{
+    return nbFailures;
+}
+
+std::vector<Vector2> generateUniformPoints(std::size_t nbPoints, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    std::vector<Vector2> points(nbPoints);
+    for (Vector2& point : points)
+    {
+        point.x = distribution(generator);
+        point.y = distribution(generator);
+    }
+    return points;
+}
+
+std::vector<Vector2> generateIntegerPoints(std::size_t nbPoints, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, INTEGER_GRID_SIZE);
+    std::vector<Vector2> points(nbPoints);
+    for (Vector2& point : points)
+    {
+        point.x = distribution(generator);
+        point.y = distribution(generator);
+    }
+    // Some exact duplicates in addition to the ones given by the grid
+    for (std::size_t i = 0; i < nbPoints / 10; ++i)
+        points.push_back(points[generator() % nbPoints]);
+    return points;
+}
+
+std::vector<Vector2> getDuplicateSitePoints()
+{
+    return {Vector2(10.0, 10.0), Vector2(20.0, 30.0), Vector2(40.0, 5.0), Vector2(20.0, 30.0), Vector2(35.0, 25.0),
+        Vector2(5.0, 40.0)};
+}
+
+std::string getName(FortuneAlgorithmBase::SiteEventMode mode)
+{
+    return mode == FortuneAlgorithmBase::SiteEventMode::HEAP ? "heap" : "sorted";
+}
+
+std::string getName(FortuneAlgorithmBase::LocationMode locationMode)
+{
+    return locationMode == FortuneAlgorithmBase::LocationMode::ROOT ? "root" : "hint";
+}
+
+std::string getName(FortuneAlgorithmBase::PredicateMode predicateMode)
+{
+    return predicateMode == FortuneAlgorithmBase::PredicateMode::FLOATING ? "floating" : "integer";
+}
+
+double computeArea(const std::vector<Vector2>& vertices)
+{
+    double area = 0.0;
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        const Vector2& point = vertices[i];
+        const Vector2& nextPoint = vertices[(i + 1) % vertices.size()];
+        area += point.x * nextPoint.y - nextPoint.x * point.y;
+    }
+    return area * 0.5;
+}
+
+bool haveSameAreas(const AreaMap& areas, const AreaMap& expectedAreas, double tolerance)
+{
+    if (areas.size() != expectedAreas.size())
+        return false;
+    for (auto it = areas.begin(), expectedIt = expectedAreas.begin(); it != areas.end(); ++it, ++expectedIt)
+    {
+        // The comparison is false if an area is NaN
+        if (it->first != expectedIt->first || !(std::abs(it->second - expectedIt->second) <= tolerance))
+            return false;
+    }
+    return true;
+}
+
+double getTotalArea(const AreaMap& areas)
+{
+    double total = 0.0;
+    for (const auto& area : areas)
+        total += area.second;
+    return total;
+}
+
+AreaMap computeBaselineAreas(const std::vector<Vector2>& points, Box boundingBox, Box box,
+    FortuneAlgorithmBase::PredicateMode predicateMode)
+{
+    FortuneAlgorithm algorithm(points);
+    algorithm.construct(FortuneAlgorithmBase::SiteEventMode::HEAP, FortuneAlgorithmBase::LocationMode::ROOT,
+        predicateMode);
+    bool valid = algorithm.bound(boundingBox);
+    VoronoiDiagram diagram = algorithm.getDiagram();
+    valid = diagram.intersect(box) && valid;
+    check(valid, "baseline " + getName(predicateMode) + " is valid");
+    return computeAreas(diagram);
+}
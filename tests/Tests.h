@@ -0,0 +1,126 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+// My includes
+#include "FortuneAlgorithm.h"
+
+// Boxes of the uniform points
+constexpr Box BOX{0.0, 0.0, 1.0, 1.0};
+constexpr Box BOUNDING_BOX{-0.05, -0.05, 1.05, 1.05};
+constexpr std::size_t NB_UNIFORM_POINTS = 2000;
+// The integer points are on a coarse grid which is also the box, so many sites are cocircular or on the border
+constexpr int INTEGER_GRID_SIZE = 64;
+constexpr Box INTEGER_BOX{0.0, 0.0, INTEGER_GRID_SIZE, INTEGER_GRID_SIZE};
+constexpr Box INTEGER_BOUNDING_BOX{-4.0, -4.0, INTEGER_GRID_SIZE + 4.0, INTEGER_GRID_SIZE + 4.0};
+constexpr std::size_t NB_INTEGER_POINTS = 1000;
+// Box of the duplicate sites
+constexpr Box DUPLICATE_BOX{0.0, 0.0, 50.0, 50.0};
+constexpr Box DUPLICATE_BOUNDING_BOX{-10.0, -10.0, 60.0, 60.0};
+// Fixed seeds so that the failures can be reproduced
+const std::vector<std::uint64_t> SEEDS = {1, 2, 3};
+
+// Checks, the failed ones are printed and counted
+void check(bool condition, const std::string& message);
+std::size_t getNbFailures();
+
+// Point sets
+std::vector<Vector2> generateUniformPoints(std::size_t nbPoints, std::uint64_t seed);
+std::vector<Vector2> generateIntegerPoints(std::size_t nbPoints, std::uint64_t seed); // With duplicates
+std::vector<Vector2> getDuplicateSitePoints(); // Input of a crash in the first line handling
+
+// Names used in the messages
+std::string getName(FortuneAlgorithmBase::SiteEventMode mode);
+std::string getName(FortuneAlgorithmBase::LocationMode locationMode);
+std::string getName(FortuneAlgorithmBase::PredicateMode predicateMode);
+
+// Area of the faces of each site point, the duplicate sites share the same entry
+// The area is NaN if a face is not a closed counterclockwise cycle
+using AreaMap = std::map<std::pair<double, double>, double>;
+
+double computeArea(const std::vector<Vector2>& vertices);
+bool haveSameAreas(const AreaMap& areas, const AreaMap& expectedAreas, double tolerance);
+double getTotalArea(const AreaMap& areas);
+
+template<typename T>
+AreaMap computeAreas(BasicVoronoiDiagram<T>& diagram)
+{
+    AreaMap areas;
+    std::size_t maxLength = diagram.getHalfEdges().getSize();
+    std::vector<Vector2> vertices;
+    for (std::size_t i = 0; i < diagram.getNbSites(); ++i)
+    {
+        const typename BasicVoronoiDiagram<T>::Site* site = diagram.getSite(i);
+        const typename BasicVoronoiDiagram<T>::HalfEdge* start = diagram.getFace(i)->outerComponent;
+        const typename BasicVoronoiDiagram<T>::HalfEdge* halfEdge = start;
+        bool closed = true;
+        vertices.clear();
+        while (halfEdge != nullptr)
+        {
+            if (halfEdge->origin == nullptr || vertices.size() > maxLength)
+            {
+                closed = false;
+                break;
+            }
+            vertices.emplace_back(static_cast<double>(halfEdge->origin->point.x),
+                static_cast<double>(halfEdge->origin->point.y));
+            halfEdge = halfEdge->next;
+            if (halfEdge == start)
+                break;
+        }
+        double area = closed && halfEdge == start ? computeArea(vertices) : std::numeric_limits<double>::quiet_NaN();
+        // Counterclockwise, up to rounding errors
+        if (area < -std::sqrt(std::numeric_limits<T>::epsilon()))
+            area = std::numeric_limits<double>::quiet_NaN();
+        areas[std::make_pair(static_cast<double>(site->point.x), static_cast<double>(site->point.y))] += area;
+    }
+    return areas;
+}
+
+// Faces with an outer component
+template<typename T>
+std::size_t countCells(BasicVoronoiDiagram<T>& diagram)
+{
+    std::size_t nbCells = 0;
+    for (std::size_t i = 0; i < diagram.getNbSites(); ++i)
+        nbCells += diagram.getFace(i)->outerComponent != nullptr;
+    return nbCells;
+}
+
+// Construction, bounding and intersection with the default algorithm and modes, the other algorithms are compared
+// with it
+AreaMap computeBaselineAreas(const std::vector<Vector2>& points, Box boundingBox, Box box,
+    FortuneAlgorithmBase::PredicateMode predicateMode = FortuneAlgorithmBase::PredicateMode::FLOATING);
+
+// Suites
+void runParallelTests();
+void runBatchTests();
+void runFinalizeTests();
+void runConstructionTests();
+void runPrecisionTests();
+void runSaveTests();
+void runEncodingTests();
+void runStreamTests();
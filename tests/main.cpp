@@ -0,0 +1,52 @@
+/* FortuneAlgorithm
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// STL
+#include <iostream>
+#include <string>
+// My includes
+#include "Tests.h"
+
+// Run the suite given as argument, or all the suites
+int main(int argc, char* argv[])
+{
+    std::string suite = argc > 1 ? argv[1] : "all";
+    bool found = false;
+    auto run = [&](const std::string& name, void (*runTests)())
+    {
+        if (suite == name || suite == "all")
+        {
+            runTests();
+            found = true;
+        }
+    };
+    run("parallel", runParallelTests);
+    run("batch", runBatchTests);
+    run("finalize", runFinalizeTests);
+    run("construction", runConstructionTests);
+    run("precision", runPrecisionTests);
+    run("save", runSaveTests);
+    run("encoding", runEncodingTests);
+    run("stream", runStreamTests);
+    if (!found)
+    {
+        std::cerr << "Unknown suite: " << suite << std::endl;
+        return 1;
+    }
+    std::cout << getNbFailures() << " failed checks" << std::endl;
+    return getNbFailures() == 0 ? 0 : 1;
+}